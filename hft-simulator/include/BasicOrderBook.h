@@ -0,0 +1,748 @@
+#ifndef BASICORDERBOOK_H
+#define BASICORDERBOOK_H
+
+#include "LevelQueue.h"
+#include "Order.h"
+#include "OrderBookPolicies.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <vector>
+
+// Outcome of a call auction: the single price every crossing order trades at
+struct AuctionResult {
+    double price;           // 0 when the book does not cross
+    std::int64_t volume;    // quantity executed (or executable) at price
+    std::int64_t imbalance; // buy quantity minus sell quantity left willing to trade at price
+};
+
+// BasicOrderBook is the price-time priority matching engine, parameterised by policies:
+//   EventSink   - receives fills, order/cancel activity and book state (NullEventSink, TradeLoggerSink, TelemetrySink<>)
+//   Clock       - stamps executions through now()                   (SimulatedClock, SystemClock)
+//   PricePolicy - maps order prices to level keys                   (DoublePrice, TickPrice<N>)
+//   Storage     - container/allocator family for levels and lookup  (StdStorage, PoolStorage)
+// Every policy call is resolved at compile time, so a NullEventSink/SimulatedClock book
+// matches without logging branches or virtual calls. OrderBook is the default instantiation.
+template <class EventSink = NullEventSink, class Clock = SimulatedClock,
+          class PricePolicy = DoublePrice, class Storage = StdStorage>
+class BasicOrderBook {
+public:
+    using PriceKey = typename PricePolicy::key_type;
+    using OrderList = typename Storage::template list<Order>;
+
+    // Orders resting at one price, in time priority, plus their queue-position state
+    struct PriceLevel {
+        PriceLevel() = default;
+        explicit PriceLevel(const typename OrderList::allocator_type& alloc) : orders(alloc) {}
+        OrderList orders;
+        LevelQueue queue;
+    };
+
+    BasicOrderBook() = default;
+    explicit BasicOrderBook(const EventSink& sink, const Clock& clock = Clock())
+        : sink_(sink), clock_(clock) {}
+
+    // Add a new order to the book (limit or market). Orders with quantity <= 0 are ignored.
+    void addOrder(const Order& order);
+    // Add a batch of orders, then match and publish book state once; the sink sees no
+    // book state for the crossed book mid-batch. Market orders still execute in batch order.
+    void addOrders(const Order* orders, std::size_t count);
+    void addOrders(const std::vector<Order>& orders);
+    // Add a market order (executes immediately at best price)
+    void addMarketOrder(const Order& order);
+    // Add a stop order (activates when stop price is reached)
+    void addStopOrder(const Order& order);
+    // Attempt to match orders (buy vs sell). Matches best prices and reports fills to the sink.
+    void matchOrders();
+    // Check and activate stop orders if price is reached
+    void checkStopOrders();
+    // Call auction (opening/closing). Until uncross(), limit orders rest without matching,
+    // matchOrders() and checkStopOrders() do nothing, and market orders are held.
+    void beginAuction();
+    bool inAuction() const { return auction_; }
+    // Equilibrium price and volume the book would uncross at now, without trading. Held
+    // market orders count at every price. One pass over the crossed levels, or over the whole
+    // opposite side of held market orders.
+    AuctionResult indicativeAuction() const;
+    // Execute every crossing order at the equilibrium price in one batch, held market orders
+    // first and then limit orders in price-time priority, and return to continuous trading.
+    // What the held market orders could not execute is dropped.
+    AuctionResult uncross();
+    // Cancel an order by ID: resting, a pending stop or a market order held by an auction.
+    // Returns true if canceled, false if not found.
+    bool cancelOrder(int order_id);
+    // Take quantity off a resting order in place, keeping its queue priority (partial cancels,
+    // executions reported by an external venue). Removes the order once nothing is left.
+    // Returns false if the order is not resting or quantity is not positive.
+    bool reduceOrder(int order_id, int quantity);
+    // Bulk cancels; each walks the affected levels once and returns the number of orders removed.
+    // Resting orders, pending stops and market orders held by an auction are all cancelled.
+    std::size_t cancelAll(int owner_id);
+    std::size_t cancelSide(Order::Side side);
+    // Cancel resting orders on one side priced within [min_price, max_price]
+    std::size_t cancelRange(Order::Side side, double min_price, double max_price);
+    // Quantity resting ahead of an order at its price level, or -1 if the order is not resting.
+    // O(log n) in the orders resting at the level (amortised); no book copy or scan.
+    std::int64_t queuePosition(int order_id) const;
+    // Get all current buy orders (for inspection/testing)
+    std::vector<Order> getBuyOrders() const;
+    // Get all current sell orders (for inspection/testing)
+    std::vector<Order> getSellOrders() const;
+    // Top of book and structure sizes, as published to the sink after every mutating call
+    BookState bookState() const;
+    // Carve the book's nodes (levels, orders, lookup) from source from now on; PoolStorage
+    // books only. Freed nodes go back to source alone, so it must outlive the book.
+    // Only possible while the book holds no resting orders; false otherwise.
+    bool useChunkSource(ChunkSource* source);
+
+    EventSink& eventSink() { return sink_; }
+    Clock& clock() { return clock_; }
+
+private:
+    using BuyLevels = typename Storage::template map<PriceKey, PriceLevel, std::greater<PriceKey>>;
+    using SellLevels = typename Storage::template map<PriceKey, PriceLevel, std::less<PriceKey>>;
+
+    struct OrderRef {
+        Order::Side side;
+        PriceKey price;
+        typename OrderList::iterator it;
+        PriceLevel* level; // map nodes are stable while the level exists
+        std::size_t seq;   // arrival sequence within the level's LevelQueue
+    };
+
+    // Buy orders: price descending (highest first)
+    BuyLevels buy_orders_;
+    // Sell orders: price ascending (lowest first)
+    SellLevels sell_orders_;
+    // Fast lookup for canceling orders by ID
+    typename Storage::template hash_map<int, OrderRef> order_lookup_;
+
+    EventSink sink_;
+    Clock clock_;
+
+    // Priority queues for fast access to best prices. A key is pushed when its level is
+    // created; entries for levels that have since emptied are discarded lazily.
+    std::priority_queue<PriceKey> buy_price_pq_; // max-heap for buy prices
+    std::priority_queue<PriceKey, std::vector<PriceKey>, std::greater<PriceKey>> sell_price_pq_; // min-heap for sell prices
+
+    // Containers for pending stop orders
+    std::vector<Order> stop_buy_orders_;
+    std::vector<Order> stop_sell_orders_;
+
+    bool auction_ = false;
+    // Market orders received during an auction, in arrival order
+    std::vector<Order> auction_market_orders_;
+
+    // Best live level of one side, discarding stale heap entries on the way
+    template <class Levels, class PriceQueue>
+    static typename Levels::iterator bestLevel(Levels& levels, PriceQueue& pq);
+    // Append a limit order to its level on one side
+    template <class Levels, class PriceQueue>
+    void insertLimit(const Order& order, Levels& levels, PriceQueue& pq);
+    // Sweep up to quantity of a market order against the opposite side until done or the side
+    // is empty; returns the quantity traded. Trades at each resting level's price, or at
+    // *price when given (an auction uncross).
+    template <class Levels, class PriceQueue>
+    int sweep(const Order& order, int quantity, Levels& levels, PriceQueue& pq, const PriceKey* price);
+    // Remove the front order of a level, dropping the level if it empties
+    template <class Levels>
+    void popFront(Levels& levels, typename Levels::iterator level);
+    // Remove every order in [first, last) from the lookup, then drop the levels
+    template <class Levels>
+    std::size_t eraseLevels(Levels& levels, Order::Side side, typename Levels::iterator first, typename Levels::iterator last);
+    template <class Levels>
+    std::size_t eraseOwned(Levels& levels, Order::Side side, int owner_id);
+    template <class Levels>
+    static void collect(const Levels& levels, std::vector<Order>& out);
+    // Trade the front orders of two crossed levels at price, at most max_quantity; returns
+    // the quantity traded. Either level may be erased.
+    int cross(typename BuyLevels::iterator buy_level, typename SellLevels::iterator sell_level, PriceKey price,
+              int max_quantity);
+    // Equilibrium of the current book; false (and a zero result) if it does not cross
+    bool equilibrium(PriceKey& price, AuctionResult& result) const;
+
+    void emitFill(const Order& buy_order, const Order& sell_order, PriceKey price, int quantity,
+                  Order::Side aggressor, bool market_order);
+    // Report a level's new resting quantity after any change to it
+    void emitLevel(Order::Side side, PriceKey price, const PriceLevel& level);
+    // Report structure sizes to the sink; compiles away for sinks that ignore them
+    void publishState();
+
+    // Route an order to its side, stop list or auction without publishing book state
+    void insertOrder(const Order& order);
+    // Helper to remove order from book and lookup
+    void removeOrder(int order_id);
+    // Remove a pending stop or held auction market order by ID (linear in their number)
+    bool removeHeld(int order_id);
+};
+
+// ---- Implementation ----
+
+template <class EventSink, class Clock, class PricePolicy, class Storage>
+void BasicOrderBook<EventSink, Clock, PricePolicy, Storage>::addOrder(const Order& order) {
+    insertOrder(order);
+    publishState();
+}
+
+template <class EventSink, class Clock, class PricePolicy, class Storage>
+void BasicOrderBook<EventSink, Clock, PricePolicy, Storage>::insertOrder(const Order& order) {
+    // Nothing to trade; a resting empty order would also look filled to its level queue
+    if (order.getQuantity() <= 0) return;
+    sink_.onOrderAdded(order);
+    if (order.getOrderType() == Order::OrderType::MARKET) {
+        if (auction_) {
+            auction_market_orders_.push_back(order);
+        } else {
+            addMarketOrder(order);
+        }
+    } else if (order.getOrderType() == Order::OrderType::STOP) {
+        addStopOrder(order);
+    } else if (order.getSide() == Order::Side::BUY) {
+        insertLimit(order, buy_orders_, buy_price_pq_);
+    } else {
+        insertLimit(order, sell_orders_, sell_price_pq_);
+    }
+}
+
+template <class EventSink, class Clock, class PricePolicy, class Storage>
+void BasicOrderBook<EventSink, Clock, PricePolicy, Storage>::addOrders(const Order* orders, std::size_t count) {
+    order_lookup_.reserve(order_lookup_.size() + count);
+    for (std::size_t i = 0; i < count; ++i) {
+        insertOrder(orders[i]);
+    }
+    // Publishes the state of the whole batch
+    matchOrders();
+}
+
+template <class EventSink, class Clock, class PricePolicy, class Storage>
+void BasicOrderBook<EventSink, Clock, PricePolicy, Storage>::addOrders(const std::vector<Order>& orders) {
+    addOrders(orders.data(), orders.size());
+}
+
+template <class EventSink, class Clock, class PricePolicy, class Storage>
+template <class Levels, class PriceQueue>
+void BasicOrderBook<EventSink, Clock, PricePolicy, Storage>::insertLimit(const Order& order, Levels& levels, PriceQueue& pq) {
+    PriceKey key = PricePolicy::toKey(order.getPrice());
+    // Level order lists share the levels' allocator (and so their chunk source)
+    std::pair<typename Levels::iterator, bool> level =
+        levels.try_emplace(key, typename OrderList::allocator_type(levels.get_allocator()));
+    if (level.second) pq.push(key);
+    PriceLevel& price_level = level.first->second;
+    price_level.orders.push_back(order);
+    std::size_t seq = price_level.queue.append(order.getQuantity());
+    order_lookup_[order.getOrderID()] = OrderRef{order.getSide(), key, std::prev(price_level.orders.end()), &price_level, seq};
+    emitLevel(order.getSide(), key, price_level);
+}
+
+template <class EventSink, class Clock, class PricePolicy, class Storage>
+void BasicOrderBook<EventSink, Clock, PricePolicy, Storage>::addMarketOrder(const Order& order) {
+    int traded = order.getSide() == Order::Side::BUY
+        ? sweep(order, order.getQuantity(), sell_orders_, sell_price_pq_, nullptr)
+        : sweep(order, order.getQuantity(), buy_orders_, buy_price_pq_, nullptr);
+    // If quantity remains after the sweep, the market order is not fully filled and the remainder is dropped
+    if (traded < order.getQuantity()) sink_.onRemainderDropped(order.getOrderID(), order.getQuantity() - traded);
+}
+
+template <class EventSink, class Clock, class PricePolicy, class Storage>
+template <class Levels, class PriceQueue>
+int BasicOrderBook<EventSink, Clock, PricePolicy, Storage>::sweep(const Order& order, int quantity, Levels& levels,
+                                                                  PriceQueue& pq, const PriceKey* price) {
+    bool is_buy = order.getSide() == Order::Side::BUY;
+    int remaining_qty = quantity;
+    while (remaining_qty > 0) {
+        typename Levels::iterator level = bestLevel(levels, pq);
+        if (level == levels.end()) break;
+        Order& resting = level->second.orders.front();
+        int trade_qty = std::min(remaining_qty, resting.getQuantity());
+        level->second.queue.consume(trade_qty);
+        PriceKey trade_price = price ? *price : level->first;
+        if (is_buy) {
+            emitFill(order, resting, trade_price, trade_qty, order.getSide(), true);
+        } else {
+            emitFill(resting, order, trade_price, trade_qty, order.getSide(), true);
+        }
+        emitLevel(resting.getSide(), level->first, level->second);
+        remaining_qty -= trade_qty;
+        resting.setQuantity(resting.getQuantity() - trade_qty);
+        if (resting.getQuantity() == 0) {
+            popFront(levels, level);
+        }
+    }
+    return quantity - remaining_qty;
+}
+
+template <class EventSink, class Clock, class PricePolicy, class Storage>
+void BasicOrderBook<EventSink, Clock, PricePolicy, Storage>::addStopOrder(const Order& order) {
+    if (order.getSide() == Order::Side::BUY) {
+        stop_buy_orders_.push_back(order);
+    } else {
+        stop_sell_orders_.push_back(order);
+    }
+}
+
+template <class EventSink, class Clock, class PricePolicy, class Storage>
+void BasicOrderBook<EventSink, Clock, PricePolicy, Storage>::checkStopOrders() {
+    if (auction_) {
+        publishState();
+        return;
+    }
+    // Activate buy stop orders if best sell <= stop price
+    typename SellLevels::iterator best_sell = bestLevel(sell_orders_, sell_price_pq_);
+    if (best_sell != sell_orders_.end()) {
+        double best_sell_price = PricePolicy::toPrice(best_sell->first);
+        std::vector<Order> still_pending;
+        for (size_t i = 0; i < stop_buy_orders_.size(); ++i) {
+            const Order& o = stop_buy_orders_[i];
+            if (!sell_orders_.empty() && best_sell_price <= o.getStopPrice()) {
+                // Activate as market order
+                Order market_order(o.getOrderID(), o.getSide(), 0.0, o.getQuantity(), o.getTimestamp(), Order::OrderType::MARKET);
+                addMarketOrder(market_order);
+            } else {
+                still_pending.push_back(o);
+            }
+        }
+        stop_buy_orders_.swap(still_pending);
+    }
+    // Activate sell stop orders if best buy >= stop price
+    typename BuyLevels::iterator best_buy = bestLevel(buy_orders_, buy_price_pq_);
+    if (best_buy != buy_orders_.end()) {
+        double best_buy_price = PricePolicy::toPrice(best_buy->first);
+        std::vector<Order> still_pending;
+        for (size_t i = 0; i < stop_sell_orders_.size(); ++i) {
+            const Order& o = stop_sell_orders_[i];
+            if (!buy_orders_.empty() && best_buy_price >= o.getStopPrice()) {
+                // Activate as market order
+                Order market_order(o.getOrderID(), o.getSide(), 0.0, o.getQuantity(), o.getTimestamp(), Order::OrderType::MARKET);
+                addMarketOrder(market_order);
+            } else {
+                still_pending.push_back(o);
+            }
+        }
+        stop_sell_orders_.swap(still_pending);
+    }
+    publishState();
+}
+
+template <class EventSink, class Clock, class PricePolicy, class Storage>
+void BasicOrderBook<EventSink, Clock, PricePolicy, Storage>::matchOrders() {
+    while (!auction_) {
+        typename BuyLevels::iterator buy_level = bestLevel(buy_orders_, buy_price_pq_);
+        if (buy_level == buy_orders_.end()) break;
+        typename SellLevels::iterator sell_level = bestLevel(sell_orders_, sell_price_pq_);
+        if (sell_level == sell_orders_.end()) break;
+        if (buy_level->first < sell_level->first) break; // No match possible
+        // Trade at the resting sell price
+        cross(buy_level, sell_level, sell_level->first, std::numeric_limits<int>::max());
+    }
+    publishState();
+}
+
+template <class EventSink, class Clock, class PricePolicy, class Storage>
+int BasicOrderBook<EventSink, Clock, PricePolicy, Storage>::cross(typename BuyLevels::iterator buy_level,
+                                                                  typename SellLevels::iterator sell_level, PriceKey price,
+                                                                  int max_quantity) {
+    Order& buy_order = buy_level->second.orders.front();
+    Order& sell_order = sell_level->second.orders.front();
+    int trade_qty = std::min(std::min(buy_order.getQuantity(), sell_order.getQuantity()), max_quantity);
+    buy_level->second.queue.consume(trade_qty);
+    sell_level->second.queue.consume(trade_qty);
+    // Aggressor is the order that arrived last
+    Order::Side aggressor = (buy_order.getTimestamp() > sell_order.getTimestamp()) ? Order::Side::BUY : Order::Side::SELL;
+    emitFill(buy_order, sell_order, price, trade_qty, aggressor, false);
+    emitLevel(Order::Side::BUY, buy_level->first, buy_level->second);
+    emitLevel(Order::Side::SELL, sell_level->first, sell_level->second);
+    buy_order.setQuantity(buy_order.getQuantity() - trade_qty);
+    sell_order.setQuantity(sell_order.getQuantity() - trade_qty);
+    if (buy_order.getQuantity() == 0) {
+        popFront(buy_orders_, buy_level);
+    }
+    if (sell_order.getQuantity() == 0) {
+        popFront(sell_orders_, sell_level);
+    }
+    return trade_qty;
+}
+
+template <class EventSink, class Clock, class PricePolicy, class Storage>
+void BasicOrderBook<EventSink, Clock, PricePolicy, Storage>::beginAuction() {
+    auction_ = true;
+}
+
+template <class EventSink, class Clock, class PricePolicy, class Storage>
+AuctionResult BasicOrderBook<EventSink, Clock, PricePolicy, Storage>::indicativeAuction() const {
+    PriceKey price;
+    AuctionResult result;
+    equilibrium(price, result);
+    return result;
+}
+
+template <class EventSink, class Clock, class PricePolicy, class Storage>
+bool BasicOrderBook<EventSink, Clock, PricePolicy, Storage>::equilibrium(PriceKey& price, AuctionResult& result) const {
+    result = AuctionResult{0.0, 0, 0};
+    // Held market orders are willing to trade at any price, so they count towards demand or
+    // supply at every candidate
+    std::int64_t market_buy = 0;
+    std::int64_t market_sell = 0;
+    for (std::size_t i = 0; i < auction_market_orders_.size(); ++i) {
+        const Order& o = auction_market_orders_[i];
+        (o.getSide() == Order::Side::BUY ? market_buy : market_sell) += o.getQuantity();
+    }
+
+    // Only levels inside [best_ask, best_bid] can trade, or the whole opposite side of held
+    // market orders. Both lists run from low to high price.
+    std::vector<std::pair<PriceKey, std::int64_t>> bids;
+    std::vector<std::pair<PriceKey, std::int64_t>> asks;
+    std::int64_t demand = market_buy;
+    for (typename BuyLevels::const_iterator it = buy_orders_.begin(); it != buy_orders_.end(); ++it) {
+        if (market_sell == 0 && (sell_orders_.empty() || it->first < sell_orders_.begin()->first)) break;
+        bids.emplace_back(it->first, it->second.queue.resting());
+        demand += it->second.queue.resting();
+    }
+    std::reverse(bids.begin(), bids.end());
+    for (typename SellLevels::const_iterator it = sell_orders_.begin(); it != sell_orders_.end(); ++it) {
+        if (market_buy == 0 && (buy_orders_.empty() || buy_orders_.begin()->first < it->first)) break;
+        asks.emplace_back(it->first, it->second.queue.resting());
+    }
+
+    // Walk every candidate price upwards. demand is the bid quantity priced at or above the
+    // candidate and supply the ask quantity at or below it; min(demand, supply) executes.
+    // Ties on volume go to the smaller imbalance, then to the higher price when buyers are
+    // left over and the lower price otherwise.
+    std::int64_t supply = market_sell;
+    std::size_t b = 0;
+    std::size_t a = 0;
+    while (b < bids.size() || a < asks.size()) {
+        PriceKey candidate = (a == asks.size() || (b < bids.size() && bids[b].first < asks[a].first)) ? bids[b].first : asks[a].first;
+        while (a < asks.size() && !(candidate < asks[a].first)) supply += asks[a++].second;
+        std::int64_t volume = std::min(demand, supply);
+        std::int64_t imbalance = demand - supply;
+        std::int64_t skew = imbalance < 0 ? -imbalance : imbalance;
+        std::int64_t best_skew = result.imbalance < 0 ? -result.imbalance : result.imbalance;
+        if (volume > result.volume || (volume > 0 && volume == result.volume && (skew < best_skew || (skew == best_skew && imbalance > 0)))) {
+            price = candidate;
+            result = AuctionResult{PricePolicy::toPrice(candidate), volume, imbalance};
+        }
+        while (b < bids.size() && !(candidate < bids[b].first)) demand -= bids[b++].second;
+    }
+    return result.volume > 0;
+}
+
+template <class EventSink, class Clock, class PricePolicy, class Storage>
+AuctionResult BasicOrderBook<EventSink, Clock, PricePolicy, Storage>::uncross() {
+    PriceKey price;
+    AuctionResult result;
+    std::int64_t remaining = equilibrium(price, result) ? result.volume : 0;
+    std::vector<Order> buys;
+    std::vector<Order> sells;
+    for (std::size_t i = 0; i < auction_market_orders_.size(); ++i) {
+        const Order& o = auction_market_orders_[i];
+        (o.getSide() == Order::Side::BUY ? buys : sells).push_back(o);
+    }
+    auction_market_orders_.clear();
+
+    // Every side fills held market orders first, in arrival order, then limit orders in
+    // price-time priority. Bids at or above and asks at or below the price cover the volume,
+    // so the best levels never leave that range before it is done.
+    std::size_t b = 0;
+    std::size_t s = 0;
+    while (remaining > 0 && b < buys.size() && s < sells.size()) {
+        Order& buy = buys[b];
+        Order& sell = sells[s];
+        int trade_qty = static_cast<int>(std::min<std::int64_t>(std::min(buy.getQuantity(), sell.getQuantity()), remaining));
+        Order::Side aggressor = (buy.getTimestamp() > sell.getTimestamp()) ? Order::Side::BUY : Order::Side::SELL;
+        emitFill(buy, sell, price, trade_qty, aggressor, true);
+        buy.setQuantity(buy.getQuantity() - trade_qty);
+        sell.setQuantity(sell.getQuantity() - trade_qty);
+        remaining -= trade_qty;
+        if (buy.getQuantity() == 0) ++b;
+        if (sell.getQuantity() == 0) ++s;
+    }
+    for (; remaining > 0 && b < buys.size(); ++b) {
+        int limit = static_cast<int>(std::min<std::int64_t>(buys[b].getQuantity(), remaining));
+        int traded = sweep(buys[b], limit, sell_orders_, sell_price_pq_, &price);
+        buys[b].setQuantity(buys[b].getQuantity() - traded);
+        remaining -= traded;
+    }
+    for (; remaining > 0 && s < sells.size(); ++s) {
+        int limit = static_cast<int>(std::min<std::int64_t>(sells[s].getQuantity(), remaining));
+        int traded = sweep(sells[s], limit, buy_orders_, buy_price_pq_, &price);
+        sells[s].setQuantity(sells[s].getQuantity() - traded);
+        remaining -= traded;
+    }
+    while (remaining > 0) {
+        int limit = static_cast<int>(std::min<std::int64_t>(remaining, std::numeric_limits<int>::max()));
+        remaining -= cross(bestLevel(buy_orders_, buy_price_pq_), bestLevel(sell_orders_, sell_price_pq_), price, limit);
+    }
+    auction_ = false;
+    // Market orders are not carried into continuous trading: what did not execute is dropped
+    std::vector<Order>* held_lists[] = {&buys, &sells};
+    for (std::vector<Order>* held : held_lists) {
+        for (std::size_t i = 0; i < held->size(); ++i) {
+            if ((*held)[i].getQuantity() > 0) sink_.onRemainderDropped((*held)[i].getOrderID(), (*held)[i].getQuantity());
+        }
+    }
+    publishState();
+    return result;
+}
+
+template <class EventSink, class Clock, class PricePolicy, class Storage>
+template <class Levels, class PriceQueue>
+typename Levels::iterator BasicOrderBook<EventSink, Clock, PricePolicy, Storage>::bestLevel(Levels& levels, PriceQueue& pq) {
+    // Every live level has a heap entry, so the heap top is either the first level of the
+    // map or a stale key for a level that has since emptied.
+    while (!pq.empty()) {
+        if (!levels.empty() && levels.begin()->first == pq.top()) return levels.begin();
+        pq.pop();
+    }
+    return levels.end();
+}
+
+template <class EventSink, class Clock, class PricePolicy, class Storage>
+template <class Levels>
+void BasicOrderBook<EventSink, Clock, PricePolicy, Storage>::popFront(Levels& levels, typename Levels::iterator level) {
+    // The front order was filled, so the level queue already accounts for it
+    order_lookup_.erase(level->second.orders.front().getOrderID());
+    level->second.orders.pop_front();
+    if (level->second.orders.empty()) {
+        levels.erase(level);
+    }
+}
+
+template <class EventSink, class Clock, class PricePolicy, class Storage>
+void BasicOrderBook<EventSink, Clock, PricePolicy, Storage>::emitFill(const Order& buy_order, const Order& sell_order, PriceKey price,
+                                                                      int quantity, Order::Side aggressor, bool market_order) {
+    sink_.onFill(Fill{buy_order.getOrderID(), sell_order.getOrderID(), PricePolicy::toPrice(price), quantity, clock_.now(),
+                      aggressor, market_order, buy_order.getOwnerID(), sell_order.getOwnerID()});
+}
+
+template <class EventSink, class Clock, class PricePolicy, class Storage>
+void BasicOrderBook<EventSink, Clock, PricePolicy, Storage>::emitLevel(Order::Side side, PriceKey price, const PriceLevel& level) {
+    sink_.onLevelChange(LevelUpdate{side, PricePolicy::toPrice(price), level.queue.resting()});
+}
+
+template <class EventSink, class Clock, class PricePolicy, class Storage>
+bool BasicOrderBook<EventSink, Clock, PricePolicy, Storage>::cancelOrder(int order_id) {
+    if (order_lookup_.find(order_id) != order_lookup_.end()) {
+        removeOrder(order_id);
+    } else if (!removeHeld(order_id)) {
+        return false;
+    }
+    sink_.onOrdersCancelled(1);
+    publishState();
+    return true;
+}
+
+template <class EventSink, class Clock, class PricePolicy, class Storage>
+bool BasicOrderBook<EventSink, Clock, PricePolicy, Storage>::reduceOrder(int order_id, int quantity) {
+    if (quantity <= 0) return false;
+    typename Storage::template hash_map<int, OrderRef>::iterator it = order_lookup_.find(order_id);
+    if (it == order_lookup_.end()) return false;
+    const OrderRef& ref = it->second;
+    if (quantity >= ref.it->getQuantity()) {
+        removeOrder(order_id);
+        sink_.onOrdersCancelled(1);
+    } else {
+        ref.level->queue.cancel(ref.seq, quantity);
+        ref.it->setQuantity(ref.it->getQuantity() - quantity);
+        emitLevel(ref.side, ref.price, *ref.level);
+    }
+    publishState();
+    return true;
+}
+
+template <class EventSink, class Clock, class PricePolicy, class Storage>
+bool BasicOrderBook<EventSink, Clock, PricePolicy, Storage>::useChunkSource(ChunkSource* source) {
+    if (!buy_orders_.empty() || !sell_orders_.empty() || !order_lookup_.empty()) return false;
+    using Lookup = typename Storage::template hash_map<int, OrderRef>;
+    // The allocators propagate on move assignment, so the containers adopt the source
+    buy_orders_ = BuyLevels(typename BuyLevels::allocator_type(source));
+    sell_orders_ = SellLevels(typename SellLevels::allocator_type(source));
+    order_lookup_ = Lookup(typename Lookup::allocator_type(source));
+    return true;
+}
+
+template <class EventSink, class Clock, class PricePolicy, class Storage>
+BookState BasicOrderBook<EventSink, Clock, PricePolicy, Storage>::bookState() const {
+    BookState state = {buy_orders_.size(), sell_orders_.size(), order_lookup_.size(),
+                       stop_buy_orders_.size() + stop_sell_orders_.size(),
+                       buy_price_pq_.size(), sell_price_pq_.size(), 0.0, 0, 0.0, 0};
+    if (!buy_orders_.empty()) {
+        state.best_bid = PricePolicy::toPrice(buy_orders_.begin()->first);
+        state.best_bid_quantity = buy_orders_.begin()->second.queue.resting();
+    }
+    if (!sell_orders_.empty()) {
+        state.best_ask = PricePolicy::toPrice(sell_orders_.begin()->first);
+        state.best_ask_quantity = sell_orders_.begin()->second.queue.resting();
+    }
+    return state;
+}
+
+template <class EventSink, class Clock, class PricePolicy, class Storage>
+void BasicOrderBook<EventSink, Clock, PricePolicy, Storage>::publishState() {
+    sink_.onBookState(bookState());
+}
+
+template <class EventSink, class Clock, class PricePolicy, class Storage>
+void BasicOrderBook<EventSink, Clock, PricePolicy, Storage>::removeOrder(int order_id) {
+    typename Storage::template hash_map<int, OrderRef>::iterator it = order_lookup_.find(order_id);
+    if (it == order_lookup_.end()) return;
+    const OrderRef& ref = it->second;
+    ref.level->queue.cancel(ref.seq, ref.it->getQuantity());
+    emitLevel(ref.side, ref.price, *ref.level);
+    ref.level->orders.erase(ref.it);
+    if (ref.level->orders.empty()) {
+        // Priority queues may now hold a stale price; bestLevel() skips it
+        if (ref.side == Order::Side::BUY) {
+            buy_orders_.erase(ref.price);
+        } else {
+            sell_orders_.erase(ref.price);
+        }
+    }
+    order_lookup_.erase(it);
+}
+
+template <class EventSink, class Clock, class PricePolicy, class Storage>
+bool BasicOrderBook<EventSink, Clock, PricePolicy, Storage>::removeHeld(int order_id) {
+    std::vector<Order>* held_lists[] = {&stop_buy_orders_, &stop_sell_orders_, &auction_market_orders_};
+    for (std::vector<Order>* held : held_lists) {
+        for (std::vector<Order>::iterator it = held->begin(); it != held->end(); ++it) {
+            if (it->getOrderID() == order_id) {
+                held->erase(it);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+template <class EventSink, class Clock, class PricePolicy, class Storage>
+std::size_t BasicOrderBook<EventSink, Clock, PricePolicy, Storage>::cancelAll(int owner_id) {
+    std::size_t removed = eraseOwned(buy_orders_, Order::Side::BUY, owner_id) + eraseOwned(sell_orders_, Order::Side::SELL, owner_id);
+    // Pending stops and market orders held by an auction
+    std::vector<Order>* stop_lists[] = {&stop_buy_orders_, &stop_sell_orders_, &auction_market_orders_};
+    for (std::vector<Order>* stops : stop_lists) {
+        std::vector<Order>::iterator keep = std::remove_if(stops->begin(), stops->end(),
+            [owner_id](const Order& o) { return o.getOwnerID() == owner_id; });
+        removed += static_cast<std::size_t>(stops->end() - keep);
+        stops->erase(keep, stops->end());
+    }
+    sink_.onOrdersCancelled(removed);
+    publishState();
+    return removed;
+}
+
+template <class EventSink, class Clock, class PricePolicy, class Storage>
+std::size_t BasicOrderBook<EventSink, Clock, PricePolicy, Storage>::cancelSide(Order::Side side) {
+    std::size_t removed;
+    if (side == Order::Side::BUY) {
+        removed = eraseLevels(buy_orders_, side, buy_orders_.begin(), buy_orders_.end()) + stop_buy_orders_.size();
+        buy_price_pq_ = decltype(buy_price_pq_)();
+        stop_buy_orders_.clear();
+    } else {
+        removed = eraseLevels(sell_orders_, side, sell_orders_.begin(), sell_orders_.end()) + stop_sell_orders_.size();
+        sell_price_pq_ = decltype(sell_price_pq_)();
+        stop_sell_orders_.clear();
+    }
+    // Market orders of this side held by an auction
+    std::vector<Order>::iterator keep = std::remove_if(auction_market_orders_.begin(), auction_market_orders_.end(),
+        [side](const Order& o) { return o.getSide() == side; });
+    removed += static_cast<std::size_t>(auction_market_orders_.end() - keep);
+    auction_market_orders_.erase(keep, auction_market_orders_.end());
+    sink_.onOrdersCancelled(removed);
+    publishState();
+    return removed;
+}
+
+template <class EventSink, class Clock, class PricePolicy, class Storage>
+std::size_t BasicOrderBook<EventSink, Clock, PricePolicy, Storage>::cancelRange(Order::Side side, double min_price, double max_price) {
+    PriceKey low = PricePolicy::toKey(min_price);
+    PriceKey high = PricePolicy::toKey(max_price);
+    if (high < low) return 0;
+    // Heap entries of erased levels go stale and are skipped by bestLevel()
+    std::size_t removed;
+    if (side == Order::Side::BUY) {
+        // Buy levels run from high to low
+        removed = eraseLevels(buy_orders_, side, buy_orders_.lower_bound(high), buy_orders_.upper_bound(low));
+    } else {
+        removed = eraseLevels(sell_orders_, side, sell_orders_.lower_bound(low), sell_orders_.upper_bound(high));
+    }
+    sink_.onOrdersCancelled(removed);
+    publishState();
+    return removed;
+}
+
+template <class EventSink, class Clock, class PricePolicy, class Storage>
+template <class Levels>
+std::size_t BasicOrderBook<EventSink, Clock, PricePolicy, Storage>::eraseLevels(Levels& levels, Order::Side side,
+                                                                                typename Levels::iterator first,
+                                                                                typename Levels::iterator last) {
+    std::size_t removed = 0;
+    for (typename Levels::iterator level = first; level != last; ++level) {
+        for (typename OrderList::const_iterator it = level->second.orders.begin(); it != level->second.orders.end(); ++it) {
+            order_lookup_.erase(it->getOrderID());
+            ++removed;
+        }
+        sink_.onLevelChange(LevelUpdate{side, PricePolicy::toPrice(level->first), 0});
+    }
+    levels.erase(first, last);
+    return removed;
+}
+
+template <class EventSink, class Clock, class PricePolicy, class Storage>
+template <class Levels>
+std::size_t BasicOrderBook<EventSink, Clock, PricePolicy, Storage>::eraseOwned(Levels& levels, Order::Side side, int owner_id) {
+    std::size_t removed = 0;
+    typename Levels::iterator level = levels.begin();
+    while (level != levels.end()) {
+        OrderList& orders = level->second.orders;
+        bool changed = false;
+        for (typename OrderList::iterator it = orders.begin(); it != orders.end();) {
+            if (it->getOwnerID() == owner_id) {
+                typename Storage::template hash_map<int, OrderRef>::iterator ref = order_lookup_.find(it->getOrderID());
+                level->second.queue.cancel(ref->second.seq, it->getQuantity());
+                order_lookup_.erase(ref);
+                it = orders.erase(it);
+                ++removed;
+                changed = true;
+            } else {
+                ++it;
+            }
+        }
+        if (changed) emitLevel(side, level->first, level->second);
+        level = orders.empty() ? levels.erase(level) : std::next(level);
+    }
+    return removed;
+}
+
+template <class EventSink, class Clock, class PricePolicy, class Storage>
+std::int64_t BasicOrderBook<EventSink, Clock, PricePolicy, Storage>::queuePosition(int order_id) const {
+    typename Storage::template hash_map<int, OrderRef>::const_iterator it = order_lookup_.find(order_id);
+    if (it == order_lookup_.end()) return -1;
+    return it->second.level->queue.ahead(it->second.seq);
+}
+
+template <class EventSink, class Clock, class PricePolicy, class Storage>
+template <class Levels>
+void BasicOrderBook<EventSink, Clock, PricePolicy, Storage>::collect(const Levels& levels, std::vector<Order>& out) {
+    for (typename Levels::const_iterator it = levels.begin(); it != levels.end(); ++it) {
+        out.insert(out.end(), it->second.orders.begin(), it->second.orders.end());
+    }
+}
+
+template <class EventSink, class Clock, class PricePolicy, class Storage>
+std::vector<Order> BasicOrderBook<EventSink, Clock, PricePolicy, Storage>::getBuyOrders() const {
+    std::vector<Order> result;
+    collect(buy_orders_, result);
+    return result;
+}
+
+template <class EventSink, class Clock, class PricePolicy, class Storage>
+std::vector<Order> BasicOrderBook<EventSink, Clock, PricePolicy, Storage>::getSellOrders() const {
+    std::vector<Order> result;
+    collect(sell_orders_, result);
+    return result;
+}
+
+#endif // BASICORDERBOOK_H
@@ -0,0 +1,119 @@
+#ifndef COLUMNARTRADESTORE_H
+#define COLUMNARTRADESTORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Columnar, lightly compressed storage for fills.
+//
+// Rows are buffered into chunks; each chunk stores every column as its own encoded block:
+//   TIMESTAMP, PRICE, BUY/SELL_ORDER_ID  delta + zigzag varint (prices as integer ticks)
+//   QUANTITY                             varint
+//   AGGRESSOR                            bitmap, 1 = BUY
+//   BUY/SELL_OWNER_ID                    dictionary of distinct values + varint indices
+// A footer records, per chunk, the row count and each column's offset, size and min/max.
+// Readers use it to skip whole chunks by statistics and to decode a single column without
+// touching the others.
+//
+// Layout: "HFTC" u32 version i64 price_scale | chunk blocks ... | footer | u64 footer_offset "HFTC"
+// All integers are little-endian.
+enum class TradeColumn : std::uint8_t {
+    TIMESTAMP,
+    PRICE,
+    QUANTITY,
+    BUY_ORDER_ID,
+    SELL_ORDER_ID,
+    AGGRESSOR,
+    BUY_OWNER_ID,
+    SELL_OWNER_ID,
+    COUNT
+};
+
+const std::size_t kTradeColumnCount = static_cast<std::size_t>(TradeColumn::COUNT);
+
+// One fill, in the column store's numeric form
+struct FillRecord {
+    std::uint64_t timestamp;
+    double price;
+    int quantity;
+    int buy_order_id;
+    int sell_order_id;
+    bool buy_aggressor;
+    int buy_owner_id;
+    int sell_owner_id;
+};
+
+struct ColumnChunkInfo {
+    std::uint64_t offset; // file offset of the encoded block
+    std::uint32_t bytes;
+    std::int64_t min;     // price in ticks; aggressor 0/1
+    std::int64_t max;
+};
+
+struct TradeChunkInfo {
+    std::uint32_t rows;
+    ColumnChunkInfo columns[kTradeColumnCount];
+
+    const ColumnChunkInfo& column(TradeColumn c) const { return columns[static_cast<std::size_t>(c)]; }
+};
+
+class ColumnarTradeWriter {
+public:
+    // price_scale: ticks per price unit used to store prices exactly
+    explicit ColumnarTradeWriter(const std::string& filename, std::size_t chunk_rows = 65536,
+                                 std::int64_t price_scale = 10000);
+    ~ColumnarTradeWriter();
+
+    ColumnarTradeWriter(const ColumnarTradeWriter&) = delete;
+    ColumnarTradeWriter& operator=(const ColumnarTradeWriter&) = delete;
+
+    void append(const FillRecord& record);
+    // Flush the open chunk and write the footer. Called by the destructor if needed.
+    void close();
+    bool isOpen() const { return file_.is_open(); }
+    std::uint64_t rowsWritten() const { return rows_written_; }
+
+private:
+    std::ofstream file_;
+    std::size_t chunk_rows_;
+    std::int64_t price_scale_;
+    std::uint64_t offset_ = 0;
+    std::uint64_t rows_written_ = 0;
+    std::vector<std::int64_t> columns_[kTradeColumnCount];
+    std::vector<TradeChunkInfo> chunks_;
+
+    void flushChunk();
+    void writeBytes(const std::vector<std::uint8_t>& bytes);
+};
+
+class ColumnarTradeReader {
+public:
+    explicit ColumnarTradeReader(const std::string& filename);
+
+    bool isOpen() const { return valid_; }
+    std::int64_t priceScale() const { return price_scale_; }
+    std::size_t chunkCount() const { return chunks_.size(); }
+    const TradeChunkInfo& chunk(std::size_t i) const { return chunks_[i]; }
+    std::uint64_t rowCount() const;
+
+    // Decode one column of one chunk; other columns are not read. Prices come back in ticks.
+    // Empty when the block does not decode to exactly the chunk's rows (a corrupt file).
+    std::vector<std::int64_t> readColumn(std::size_t chunk, TradeColumn column);
+    // Chunks whose [min, max] for `column` overlaps [low, high]
+    std::vector<std::size_t> chunksInRange(TradeColumn column, std::int64_t low, std::int64_t high) const;
+    // Reassemble full rows of a chunk (decodes every column); empty if any column is corrupt
+    std::vector<FillRecord> readRows(std::size_t chunk);
+
+    double ticksToPrice(std::int64_t ticks) const { return static_cast<double>(ticks) / price_scale_; }
+
+private:
+    std::ifstream file_;
+    bool valid_ = false;
+    std::int64_t price_scale_ = 1;
+    std::vector<TradeChunkInfo> chunks_;
+};
+
+#endif // COLUMNARTRADESTORE_H
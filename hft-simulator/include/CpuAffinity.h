@@ -0,0 +1,23 @@
+#ifndef CPUAFFINITY_H
+#define CPUAFFINITY_H
+
+// Pin the calling thread to a single CPU. Returns false if pinning is unsupported
+// on this platform or the CPU is not available to the process.
+bool pinCurrentThread(int cpu);
+
+// CPU the calling thread is running on, or -1 if unknown
+int currentCpu();
+
+// NUMA node that owns a CPU, or -1 if unknown (single-node machines report 0)
+int numaNodeOfCpu(int cpu);
+
+// Spin-wait hint for busy-poll loops
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+}
+
+#endif // CPUAFFINITY_H
@@ -0,0 +1,120 @@
+#ifndef GATEWAYPROTOCOL_H
+#define GATEWAYPROTOCOL_H
+
+#include <cstddef>
+#include <cstdint>
+
+// Binary order-entry protocol spoken by OrderGateway.
+//
+// Every message is a fixed-layout, packed struct starting with a GatewayHeader whose
+// length covers the whole message. Fields are in host byte order (little-endian on the
+// Linux targets we run on). Prices are signed fixed-point in units of 1/kGatewayPriceScale.
+// Messages are decoded in place from the receive buffer, so the layouts below are the
+// wire format and must not be reordered.
+
+const std::int64_t kGatewayPriceScale = 10000;
+
+enum class GatewayMessageType : std::uint8_t {
+    // Client -> gateway
+    NEW_ORDER = 'N',
+    CANCEL = 'X',
+    AMEND = 'A',
+    // Gateway -> client
+    ACK = 'K',
+    REJECT = 'R',
+    FILL = 'F',
+};
+
+enum class GatewaySide : std::uint8_t { BUY = 0, SELL = 1 };
+enum class GatewayOrderType : std::uint8_t { LIMIT = 0, MARKET = 1, STOP = 2 };
+
+// What an ACK confirms. CANCELLED and EXPIRED are terminal: no more fills follow, and the
+// ACK's leaves is the quantity that will never trade. An order also ends with a FILL whose
+// leaves is 0.
+enum class GatewayAckStatus : std::uint8_t {
+    ACCEPTED = 0,
+    CANCELLED = 1,
+    AMENDED = 2,
+    EXPIRED = 3, // the book dropped the unfilled rest of a market order or triggered stop
+};
+
+enum class GatewayRejectReason : std::uint8_t {
+    UNKNOWN_ORDER = 0,  // cancel/amend of an order that is not live
+    DUPLICATE_ID = 1,   // new order reusing a live client order ID
+    INVALID_FIELDS = 2, // bad side/type, non-positive quantity, limit price or stop price
+};
+
+#pragma pack(push, 1)
+
+struct GatewayHeader {
+    std::uint16_t length; // whole message, header included
+    GatewayMessageType type;
+};
+
+struct GatewayNewOrder {
+    GatewayHeader header;
+    std::uint32_t client_order_id; // unique among the session's live orders
+    GatewaySide side;
+    GatewayOrderType order_type;
+    std::int64_t price;      // LIMIT only; a triggered stop trades as a market order
+    std::int64_t stop_price; // STOP only: trigger price
+    std::uint32_t quantity;
+};
+
+struct GatewayCancel {
+    GatewayHeader header;
+    std::uint32_t client_order_id;
+};
+
+// Cancel/replace: the order re-enters the book at the back of its new price level
+struct GatewayAmend {
+    GatewayHeader header;
+    std::uint32_t client_order_id;
+    std::int64_t price;
+    std::uint32_t quantity;
+};
+
+struct GatewayAck {
+    GatewayHeader header;
+    std::uint32_t client_order_id;
+    std::uint32_t order_id; // ID of the order in the book
+    GatewayAckStatus status;
+    std::uint32_t leaves;   // open quantity (ACCEPTED, AMENDED) or quantity that ended unfilled
+};
+
+struct GatewayReject {
+    GatewayHeader header;
+    std::uint32_t client_order_id;
+    GatewayRejectReason reason;
+};
+
+struct GatewayFill {
+    GatewayHeader header;
+    std::uint32_t client_order_id;
+    GatewaySide side; // side of the client's order
+    std::int64_t price;
+    std::uint32_t quantity;
+    std::uint32_t leaves; // quantity still open after this fill
+    std::uint64_t timestamp;
+};
+
+#pragma pack(pop)
+
+static_assert(sizeof(GatewayNewOrder) == 29, "wire layout");
+static_assert(sizeof(GatewayCancel) == 7, "wire layout");
+static_assert(sizeof(GatewayAmend) == 19, "wire layout");
+static_assert(sizeof(GatewayAck) == 16, "wire layout");
+static_assert(sizeof(GatewayReject) == 8, "wire layout");
+static_assert(sizeof(GatewayFill) == 32, "wire layout");
+
+// Fixed size of a message a client may send, or 0 for any other type
+inline std::size_t gatewayInboundSize(GatewayMessageType type) {
+    switch (type) {
+    case GatewayMessageType::NEW_ORDER: return sizeof(GatewayNewOrder);
+    case GatewayMessageType::CANCEL: return sizeof(GatewayCancel);
+    case GatewayMessageType::AMEND: return sizeof(GatewayAmend);
+    default: return 0;
+    }
+}
+
+#endif // GATEWAYPROTOCOL_H
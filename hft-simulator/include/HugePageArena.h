@@ -0,0 +1,41 @@
+#ifndef HUGEPAGEARENA_H
+#define HUGEPAGEARENA_H
+
+#include "PoolAllocator.h"
+#include <cstddef>
+
+// HugePageArena reserves one contiguous region up front and hands it out with a bump
+// pointer. On Linux the region is backed by explicit huge pages when available
+// (transparent huge pages otherwise), bound to a NUMA node, and optionally pre-faulted
+// so the hot path never takes a first-touch page fault. Memory is released only when
+// the arena is destroyed, so an arena used as a ChunkSource must outlive the containers
+// bound to it (OrderBook::attachArena ties it to the book).
+class HugePageArena : public ChunkSource {
+public:
+    // numa_node < 0 leaves placement to the kernel (first touch)
+    HugePageArena(std::size_t bytes, int numa_node = -1, bool huge_pages = true, bool prefault = true);
+    ~HugePageArena();
+
+    HugePageArena(const HugePageArena&) = delete;
+    HugePageArena& operator=(const HugePageArena&) = delete;
+
+    // Returns nullptr when the arena cannot satisfy the request
+    void* allocate(std::size_t bytes, std::size_t align);
+    void* allocateChunk(std::size_t bytes, std::size_t align) override { return allocate(bytes, align); }
+
+    bool contains(const void* p) const;
+    std::size_t capacity() const { return capacity_; }
+    std::size_t used() const { return used_; }
+    bool hugePages() const { return huge_pages_; }
+    bool numaBound() const { return numa_bound_; }
+
+private:
+    unsigned char* base_ = nullptr;
+    std::size_t capacity_ = 0;
+    std::size_t used_ = 0;
+    bool mapped_ = false;     // base_ came from mmap rather than operator new
+    bool huge_pages_ = false; // explicit huge pages (MAP_HUGETLB)
+    bool numa_bound_ = false;
+};
+
+#endif // HUGEPAGEARENA_H
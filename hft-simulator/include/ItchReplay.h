@@ -0,0 +1,286 @@
+#ifndef ITCHREPLAY_H
+#define ITCHREPLAY_H
+
+#include "MappedFile.h"
+#include "OrderBook.h"
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+// Counters from an ItchReplay run
+struct ItchStats {
+    std::uint64_t messages = 0;
+    std::uint64_t adds = 0;
+    std::uint64_t executions = 0;
+    std::uint64_t executed_shares = 0;
+    std::uint64_t cancels = 0;   // partial cancels ('X')
+    std::uint64_t deletes = 0;
+    std::uint64_t replaces = 0;
+    std::uint64_t ignored = 0;   // other message types, filtered symbols, unknown order refs
+    std::uint64_t malformed = 0; // shorter than their type requires, a share count of 0 or above INT_MAX,
+                                 // or an add/replace reusing a live order reference
+    bool truncated = false;      // data ended mid-message
+};
+
+// Big-endian field loads; compilers turn these into a single load + byte swap
+inline std::uint16_t itchU16(const char* p) {
+    const unsigned char* b = reinterpret_cast<const unsigned char*>(p);
+    return static_cast<std::uint16_t>((b[0] << 8) | b[1]);
+}
+
+inline std::uint32_t itchU32(const char* p) {
+    const unsigned char* b = reinterpret_cast<const unsigned char*>(p);
+    return (std::uint32_t(b[0]) << 24) | (std::uint32_t(b[1]) << 16) | (std::uint32_t(b[2]) << 8) | b[3];
+}
+
+inline std::uint64_t itchU48(const char* p) {
+    return (std::uint64_t(itchU16(p)) << 32) | itchU32(p + 2);
+}
+
+inline std::uint64_t itchU64(const char* p) {
+    return (std::uint64_t(itchU32(p)) << 32) | itchU32(p + 4);
+}
+
+// Share count that fits the book's int quantities; 0 and values above INT_MAX are rejected
+inline bool itchShares(const char* p, int& shares) {
+    std::uint32_t value = itchU32(p);
+    if (value == 0 || value > static_cast<std::uint32_t>(INT_MAX)) return false;
+    shares = static_cast<int>(value);
+    return true;
+}
+
+// Space-padded 8-character ITCH stock symbol without the padding
+inline std::string itchSymbol(const char* p) {
+    std::size_t n = 8;
+    while (n > 0 && p[n - 1] == ' ') --n;
+    return std::string(p, n);
+}
+
+// ItchReplay rebuilds per-symbol books from a NASDAQ TotalView-ITCH 5.0 style binary
+// stream: each message is preceded by a 2-byte big-endian length, and fields are big-endian.
+//
+// Stock Directory ('R'), Add Order ('A'/'F'), Order Executed ('E'/'C'), Order Cancel ('X'),
+// Order Delete ('D') and Order Replace ('U') are applied; every other type is skipped using
+// its length prefix. Books are found by stock locate through a flat 65536-entry table and
+// orders by reference number through one hash map, so each message costs O(1) lookups
+// plus the book operation itself. The books only mirror the venue: executions reduce the
+// resting order in place and nothing is matched locally.
+//
+// Order reference numbers are mapped to sequential int order IDs within each replay
+// object. For maximum speed replay into a lean book, e.g.
+// BasicOrderBook<NullEventSink, SimulatedClock, TickPrice<10000>, PoolStorage>.
+template <class Book = OrderBook>
+class ItchReplay {
+public:
+    explicit ItchReplay(std::size_t expected_orders = 1 << 20) : locates_(65536) {
+        orders_.reserve(expected_orders);
+    }
+
+    // Only build books for these symbols (empty: all). Set before replaying.
+    void setSymbolFilter(const std::vector<std::string>& symbols) {
+        filter_.clear();
+        filter_.insert(symbols.begin(), symbols.end());
+    }
+
+    // Replay a whole file; false if it cannot be opened
+    bool replayFile(const std::string& filename) {
+        MappedFile file(filename);
+        if (!file.isOpen()) return false;
+        replay(file.data(), file.size());
+        return true;
+    }
+
+    // Replay a buffer of length-prefixed messages. Books and order state carry over between
+    // calls, so a day split into several buffers can be replayed piece by piece as long as
+    // no message straddles two buffers.
+    void replay(const char* data, std::size_t size);
+
+    const ItchStats& stats() const { return stats_; }
+    // Book for a symbol, nullptr if none was built
+    Book* book(const std::string& symbol) {
+        typename std::map<std::string, std::unique_ptr<Book>>::iterator it = books_.find(symbol);
+        return it == books_.end() ? nullptr : it->second.get();
+    }
+    std::vector<std::string> symbols() const {
+        std::vector<std::string> names;
+        for (typename std::map<std::string, std::unique_ptr<Book>>::const_iterator it = books_.begin(); it != books_.end(); ++it) {
+            names.push_back(it->first);
+        }
+        return names;
+    }
+
+private:
+    struct Locate {
+        Book* book = nullptr; // nullptr: filtered out (or not yet resolved)
+        bool resolved = false;
+    };
+
+    struct Resting {
+        Book* book;
+        int order_id;
+        int remaining;
+        Order::Side side;
+    };
+
+    std::map<std::string, std::unique_ptr<Book>> books_;
+    std::unordered_set<std::string> filter_;
+    std::vector<Locate> locates_;
+    std::unordered_map<std::uint64_t, Resting> orders_;
+    int next_order_id_ = 1;
+    ItchStats stats_;
+
+    Book* resolve(std::uint16_t locate, const char* symbol);
+    // false, changing nothing, if ref already names a live order
+    bool add(Book* book, std::uint64_t ref, Order::Side side, int shares, std::uint32_t price, std::uint64_t ts);
+    void reduce(std::uint64_t ref, int shares, bool executed);
+    void remove(std::uint64_t ref);
+    void replace(std::uint64_t old_ref, std::uint64_t new_ref, int shares, std::uint32_t price, std::uint64_t ts);
+};
+
+template <class Book>
+void ItchReplay<Book>::replay(const char* data, std::size_t size) {
+    const char* p = data;
+    const char* end = data + size;
+    while (end - p >= 2) {
+        std::size_t length = itchU16(p);
+        if (static_cast<std::size_t>(end - p - 2) < length) {
+            stats_.truncated = true;
+            return;
+        }
+        const char* msg = p + 2;
+        p += 2 + length;
+        ++stats_.messages;
+        if (length == 0) {
+            ++stats_.malformed;
+            continue;
+        }
+        // Common prefix: type(1) locate(2) tracking(2) timestamp(6)
+        int shares;
+        switch (msg[0]) {
+        case 'R':
+            if (length < 39) break;
+            resolve(itchU16(msg + 1), msg + 11);
+            continue;
+        case 'A':
+        case 'F': {
+            if (length < 36 || !itchShares(msg + 20, shares)) break;
+            Book* book = resolve(itchU16(msg + 1), msg + 24);
+            if (!book) {
+                ++stats_.ignored;
+                continue;
+            }
+            Order::Side side = msg[19] == 'B' ? Order::Side::BUY : Order::Side::SELL;
+            if (!add(book, itchU64(msg + 11), side, shares, itchU32(msg + 32), itchU48(msg + 5))) break;
+            ++stats_.adds;
+            continue;
+        }
+        case 'E':
+            if (length < 31 || !itchShares(msg + 19, shares)) break;
+            reduce(itchU64(msg + 11), shares, true);
+            continue;
+        case 'C':
+            if (length < 36 || !itchShares(msg + 19, shares)) break;
+            reduce(itchU64(msg + 11), shares, true);
+            continue;
+        case 'X':
+            if (length < 23 || !itchShares(msg + 19, shares)) break;
+            reduce(itchU64(msg + 11), shares, false);
+            continue;
+        case 'D':
+            if (length < 19) break;
+            remove(itchU64(msg + 11));
+            continue;
+        case 'U':
+            if (length < 35 || !itchShares(msg + 27, shares)) break;
+            replace(itchU64(msg + 11), itchU64(msg + 19), shares, itchU32(msg + 31),
+                    itchU48(msg + 5));
+            continue;
+        default:
+            ++stats_.ignored;
+            continue;
+        }
+        // Reached only by a known type that is too short for its layout or has bad shares
+        ++stats_.malformed;
+    }
+    if (p != end) stats_.truncated = true;
+}
+
+template <class Book>
+Book* ItchReplay<Book>::resolve(std::uint16_t locate, const char* symbol) {
+    Locate& entry = locates_[locate];
+    if (entry.resolved) return entry.book;
+    entry.resolved = true;
+    std::string name = itchSymbol(symbol);
+    if (!filter_.empty() && !filter_.count(name)) return nullptr;
+    std::unique_ptr<Book>& book = books_[name];
+    if (!book) book.reset(new Book());
+    entry.book = book.get();
+    return entry.book;
+}
+
+template <class Book>
+bool ItchReplay<Book>::add(Book* book, std::uint64_t ref, Order::Side side, int shares, std::uint32_t price, std::uint64_t ts) {
+    // Overwriting the entry would orphan the first order in its book for the rest of the day
+    if (!orders_.emplace(ref, Resting{book, next_order_id_, shares, side}).second) return false;
+    int order_id = next_order_id_++;
+    book->addOrder(Order(order_id, side, price / 10000.0, shares, ts, Order::OrderType::LIMIT));
+    return true;
+}
+
+template <class Book>
+void ItchReplay<Book>::reduce(std::uint64_t ref, int shares, bool executed) {
+    typename std::unordered_map<std::uint64_t, Resting>::iterator it = orders_.find(ref);
+    if (it == orders_.end()) {
+        ++stats_.ignored;
+        return;
+    }
+    Resting& resting = it->second;
+    resting.book->reduceOrder(resting.order_id, shares);
+    resting.remaining -= shares;
+    if (resting.remaining <= 0) orders_.erase(it);
+    if (executed) {
+        ++stats_.executions;
+        stats_.executed_shares += static_cast<std::uint64_t>(shares);
+    } else {
+        ++stats_.cancels;
+    }
+}
+
+template <class Book>
+void ItchReplay<Book>::remove(std::uint64_t ref) {
+    typename std::unordered_map<std::uint64_t, Resting>::iterator it = orders_.find(ref);
+    if (it == orders_.end()) {
+        ++stats_.ignored;
+        return;
+    }
+    it->second.book->cancelOrder(it->second.order_id);
+    orders_.erase(it);
+    ++stats_.deletes;
+}
+
+template <class Book>
+void ItchReplay<Book>::replace(std::uint64_t old_ref, std::uint64_t new_ref, int shares, std::uint32_t price, std::uint64_t ts) {
+    typename std::unordered_map<std::uint64_t, Resting>::iterator it = orders_.find(old_ref);
+    if (it == orders_.end()) {
+        ++stats_.ignored;
+        return;
+    }
+    if (new_ref != old_ref && orders_.count(new_ref)) {
+        ++stats_.malformed;
+        return;
+    }
+    // The replacement keeps the side and symbol but loses time priority
+    Resting old = it->second;
+    orders_.erase(it);
+    old.book->cancelOrder(old.order_id);
+    add(old.book, new_ref, old.side, shares, price, ts);
+    ++stats_.replaces;
+}
+
+#endif // ITCHREPLAY_H
@@ -0,0 +1,40 @@
+#ifndef LATENCYMODEL_H
+#define LATENCYMODEL_H
+
+#include <cstdint>
+#include <random>
+
+// Distribution of one latency path, in nanoseconds: a fixed base plus a random jitter term.
+struct LatencyDistribution {
+    enum class Kind { CONSTANT, UNIFORM, NORMAL, EXPONENTIAL };
+
+    Kind kind = Kind::CONSTANT;
+    std::uint64_t base_ns = 0;
+    // UNIFORM: maximum extra delay; NORMAL: standard deviation; EXPONENTIAL: mean extra delay
+    double jitter_ns = 0.0;
+};
+
+struct LatencyConfig {
+    LatencyDistribution order_entry;  // strategy -> order book
+    LatencyDistribution market_data;  // order book -> strategy
+    std::uint64_t tick_ns = 1000;     // scheduler resolution; deliveries round up to a whole tick
+    std::uint64_t seed = 42;          // fixed seed keeps backtests reproducible
+};
+
+// Samples order-entry and market-data delays from a LatencyConfig.
+class LatencyModel {
+public:
+    explicit LatencyModel(const LatencyConfig& config);
+
+    std::uint64_t orderEntryDelay();
+    std::uint64_t marketDataDelay();
+    const LatencyConfig& config() const { return config_; }
+
+private:
+    LatencyConfig config_;
+    std::mt19937_64 rng_;
+
+    std::uint64_t sample(const LatencyDistribution& dist);
+};
+
+#endif // LATENCYMODEL_H
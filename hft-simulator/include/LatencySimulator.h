@@ -0,0 +1,105 @@
+#ifndef LATENCYSIMULATOR_H
+#define LATENCYSIMULATOR_H
+
+#include "LatencyModel.h"
+#include "Order.h"
+#include "OrderBookPolicies.h"
+#include "TimerWheel.h"
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+
+// LatencySimulator sits between strategies and a book. Orders and cancels reach the book
+// after a sampled order-entry delay; market-data callbacks reach strategies after a sampled
+// market-data delay. In-flight messages wait in a TimerWheel keyed on simulated time, so
+// scheduling and expiry stay O(1) however many are outstanding.
+//
+// Each strategy's order and market-data channels are delivered in send order, like a TCP
+// session, so jitter never reorders one strategy's own messages. Book is any BasicOrderBook
+// instantiation; a SimulatedClock book is kept in step with delivery times.
+template <class Book>
+class LatencySimulator {
+public:
+    LatencySimulator(Book& book, const LatencyConfig& config)
+        : book_(book), model_(config), tick_ns_(config.tick_ns > 0 ? config.tick_ns : 1) {}
+
+    // Send a new order from strategy_id at now(). Returns its simulated arrival time in ns.
+    std::uint64_t submitOrder(int strategy_id, const Order& order) {
+        return schedule(order_channel_[strategy_id], model_.orderEntryDelay(), Event{Event::NEW_ORDER, order, nullptr});
+    }
+
+    // Send a cancel from strategy_id at now(). Returns its simulated arrival time in ns.
+    std::uint64_t submitCancel(int strategy_id, int order_id) {
+        Order cancel(order_id, Order::Side::BUY, 0.0, 0, now_ns_);
+        return schedule(order_channel_[strategy_id], model_.orderEntryDelay(), Event{Event::CANCEL, cancel, nullptr});
+    }
+
+    // Publish market data produced at now() to strategy_id; `deliver` runs when it arrives.
+    std::uint64_t publishMarketData(int strategy_id, std::function<void()> deliver) {
+        Order none(0, Order::Side::BUY, 0.0, 0, now_ns_);
+        return schedule(market_data_channel_[strategy_id], model_.marketDataDelay(),
+                        Event{Event::MARKET_DATA, none, std::move(deliver)});
+    }
+
+    // Advance simulated time, applying every message due at or before time_ns in arrival order
+    void advanceTo(std::uint64_t time_ns) {
+        wheel_.advance(time_ns / tick_ns_, [this](std::uint64_t tick, Event& event) { deliver(tick, event); });
+        if (time_ns > now_ns_) now_ns_ = time_ns;
+    }
+
+    std::uint64_t now() const { return now_ns_; }
+    std::size_t inFlight() const { return wheel_.size(); }
+    LatencyModel& model() { return model_; }
+
+private:
+    struct Event {
+        enum Kind { NEW_ORDER, CANCEL, MARKET_DATA };
+        Kind kind;
+        Order order;
+        std::function<void()> callback;
+    };
+
+    Book& book_;
+    LatencyModel model_;
+    std::uint64_t tick_ns_;
+    std::uint64_t now_ns_ = 0;
+    TimerWheel<Event> wheel_;
+    // Last scheduled arrival tick per strategy and channel
+    std::unordered_map<int, std::uint64_t> order_channel_;
+    std::unordered_map<int, std::uint64_t> market_data_channel_;
+
+    std::uint64_t schedule(std::uint64_t& channel_tick, std::uint64_t delay_ns, Event event) {
+        // Round up so a message never arrives sooner than its sampled latency
+        std::uint64_t tick = (now_ns_ + delay_ns + tick_ns_ - 1) / tick_ns_;
+        if (tick < channel_tick) tick = channel_tick;
+        channel_tick = tick;
+        wheel_.schedule(tick, std::move(event));
+        return tick * tick_ns_;
+    }
+
+    void deliver(std::uint64_t tick, Event& event) {
+        std::uint64_t arrival = tick * tick_ns_;
+        if (arrival > now_ns_) now_ns_ = arrival;
+        syncClock(book_.clock(), now_ns_);
+        switch (event.kind) {
+            case Event::NEW_ORDER:
+                // Matched before book state is published, so no one sees it crossed
+                book_.addOrders(&event.order, 1);
+                book_.checkStopOrders();
+                break;
+            case Event::CANCEL:
+                book_.cancelOrder(event.order.getOrderID());
+                break;
+            case Event::MARKET_DATA:
+                event.callback();
+                break;
+        }
+    }
+
+    static void syncClock(SimulatedClock& clock, std::uint64_t time_ns) { clock.advanceTo(time_ns); }
+    template <class Clock>
+    static void syncClock(Clock&, std::uint64_t) {}
+};
+
+#endif // LATENCYSIMULATOR_H
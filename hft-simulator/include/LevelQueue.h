@@ -0,0 +1,126 @@
+#ifndef LEVELQUEUE_H
+#define LEVELQUEUE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// LevelQueue tracks the FIFO queue of one price level so the quantity ahead of any
+// resting order can be answered without walking the level.
+//
+// Each order gets an arrival sequence number when appended. A Fenwick tree over those
+// sequence numbers holds each order's original quantity, minus whatever was left when
+// it was cancelled. Fills always consume the queue from the front, so they only bump a
+// single traded counter. Quantity ahead of an order is then
+//     prefix(seq - 1) - traded
+// which goes negative only for the partially filled front order itself (clamped to 0).
+//
+// Orders that were consumed or cancelled off the front stay in the tree until the dead
+// prefix reaches half of it; append() then rebuilds the tree from the live suffix, so its
+// size follows the orders resting rather than every order that ever joined the level.
+// Sequence numbers stay valid across a rebuild (tree index = seq - base_).
+// Quantities must be positive: an empty order would be taken for a dead one.
+//   append/cancel/ahead: O(log n) amortised   consume/resting: O(1)
+class LevelQueue {
+public:
+    // Append an order with the given (positive) quantity; returns its sequence number
+    std::size_t append(std::int64_t quantity) {
+        if (tree_.size() >= next_compaction_check_) compact();
+        std::size_t index = tree_.size() + 1;
+        // Node index covers (index - lowbit(index), index]
+        std::int64_t node = quantity + prefix(index - 1) - prefix(index - lowbit(index));
+        tree_.push_back(node);
+        resting_ += quantity;
+        return base_ + index;
+    }
+
+    // Quantity executed against the front of the queue
+    void consume(std::int64_t quantity) {
+        traded_ += quantity;
+        resting_ -= quantity;
+    }
+
+    // Quantity taken off order seq without a fill from the front: all of its remainder when
+    // it is cancelled, or part of it when it is reduced in place
+    void cancel(std::size_t seq, std::int64_t quantity) {
+        if (seq <= base_) return; // compacted away: nothing of it was resting
+        resting_ -= quantity;
+        for (std::size_t i = seq - base_; i <= tree_.size(); i += lowbit(i)) {
+            tree_[i - 1] -= quantity;
+        }
+    }
+
+    // Total quantity resting at the level
+    std::int64_t resting() const { return resting_; }
+
+    // Quantity resting ahead of order seq
+    std::int64_t ahead(std::size_t seq) const {
+        if (seq <= base_) return 0;
+        std::int64_t qty = prefix(seq - base_ - 1) - traded_;
+        return qty > 0 ? qty : 0;
+    }
+
+    // Tree slots currently held (live orders plus a dead prefix not yet compacted)
+    std::size_t capacity() const { return tree_.size(); }
+
+private:
+    std::vector<std::int64_t> tree_; // 1-based Fenwick tree stored 0-based
+    std::int64_t traded_ = 0;        // consumed from the front of the orders still in the tree
+    std::int64_t resting_ = 0;
+    std::size_t base_ = 0;           // sequence number of tree index 0
+    std::size_t next_compaction_check_ = 64;
+
+    static std::size_t lowbit(std::size_t i) { return i & (~i + 1); }
+
+    std::int64_t prefix(std::size_t i) const {
+        std::int64_t sum = 0;
+        for (; i > 0; i -= lowbit(i)) {
+            sum += tree_[i - 1];
+        }
+        return sum;
+    }
+
+    // Number of leading orders that are fully consumed or cancelled. Every live order
+    // still holds quantity (appends are positive), so prefix(i) <= traded_ exactly for the
+    // dead ones.
+    std::size_t deadPrefix() const {
+        std::size_t pos = 0;
+        std::int64_t left = traded_;
+        std::size_t step = 1;
+        while (step * 2 <= tree_.size()) step *= 2;
+        for (; step > 0; step /= 2) {
+            if (pos + step <= tree_.size() && tree_[pos + step - 1] <= left) {
+                pos += step;
+                left -= tree_[pos - 1];
+            }
+        }
+        return pos;
+    }
+
+    // Drop the dead prefix once it is at least half the tree. Checked again only after the
+    // tree doubles, so the O(n) rebuild is amortised over the appends that grew it.
+    void compact() {
+        std::size_t n = tree_.size();
+        std::size_t dead = deadPrefix();
+        if (dead * 2 >= n) {
+            std::int64_t dead_quantity = prefix(dead);
+            // Fenwick nodes back to per-order values, then rebuild over the live suffix
+            for (std::size_t i = n; i > 0; --i) {
+                std::size_t parent = i + lowbit(i);
+                if (parent <= n) tree_[parent - 1] -= tree_[i - 1];
+            }
+            tree_.erase(tree_.begin(), tree_.begin() + static_cast<std::ptrdiff_t>(dead));
+            n = tree_.size();
+            for (std::size_t i = 1; i <= n; ++i) {
+                std::size_t parent = i + lowbit(i);
+                if (parent <= n) tree_[parent - 1] += tree_[i - 1];
+            }
+            base_ += dead;
+            traded_ -= dead_quantity;
+            if (tree_.capacity() > 2 * n + 64) tree_.shrink_to_fit();
+        }
+        next_compaction_check_ = 2 * tree_.size() > 64 ? 2 * tree_.size() : 64;
+    }
+};
+
+#endif // LEVELQUEUE_H
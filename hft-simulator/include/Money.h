@@ -0,0 +1,113 @@
+#ifndef MONEY_H
+#define MONEY_H
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+// Ticks per price unit for exact money amounts; the same grid as the gateway wire format
+// and the columnar trade store
+const std::int64_t kMoneyScale = 10000;
+
+// Money is an exact amount in ticks of 1/kMoneyScale, so price x quantity and running
+// P&L are integer arithmetic: no drift over long replays and the same result whatever
+// order the amounts are summed in. Arithmetic is overflow-checked: a result that does not
+// fit in 64 bits sets overflowed(), which then sticks to every amount derived from it.
+class Money {
+public:
+    Money() : ticks_(0), overflow_(false) {}
+
+    static Money fromTicks(std::int64_t ticks) { return Money(ticks, false); }
+    // Rounds to the nearest tick; prices on the tick grid convert exactly
+    static Money fromPrice(double price) {
+        double ticks = std::nearbyint(price * kMoneyScale);
+        bool fits = std::fabs(ticks) < 9.2e18;
+        return Money(fits ? static_cast<std::int64_t>(ticks) : 0, !fits);
+    }
+
+    std::int64_t ticks() const { return ticks_; }
+    double toDouble() const { return static_cast<double>(ticks_) / kMoneyScale; }
+    bool overflowed() const { return overflow_; }
+
+    Money& operator+=(const Money& other) {
+        overflow_ = add(ticks_, other.ticks_, ticks_) || overflow_ || other.overflow_;
+        return *this;
+    }
+    Money& operator-=(const Money& other) {
+        overflow_ = subtract(ticks_, other.ticks_, ticks_) || overflow_ || other.overflow_;
+        return *this;
+    }
+    Money operator-() const { return Money() - *this; }
+    friend Money operator+(Money a, const Money& b) { return a += b; }
+    friend Money operator-(Money a, const Money& b) { return a -= b; }
+    // Price x quantity
+    friend Money operator*(const Money& a, std::int64_t quantity) {
+        Money result;
+        result.overflow_ = multiply(a.ticks_, quantity, result.ticks_) || a.overflow_;
+        return result;
+    }
+
+    // this x numerator / denominator, truncated toward zero, without overflowing in between
+    // (the share of a cost basis released when part of a position closes)
+    Money scaled(std::int64_t numerator, std::int64_t denominator) const {
+#ifdef __SIZEOF_INT128__
+        __int128 product = static_cast<__int128>(ticks_) * numerator / denominator;
+        bool fits = product >= std::numeric_limits<std::int64_t>::min() && product <= std::numeric_limits<std::int64_t>::max();
+        return Money(fits ? static_cast<std::int64_t>(product) : 0, overflow_ || !fits);
+#else
+        // Split ticks into whole multiples of the denominator and a remainder
+        std::int64_t whole = ticks_ / denominator;
+        std::int64_t rest = ticks_ % denominator;
+        Money result = fromTicks(whole) * numerator;
+        std::int64_t tail;
+        bool overflow = multiply(rest, numerator, tail);
+        result += fromTicks(tail / denominator);
+        result.overflow_ = result.overflow_ || overflow || overflow_;
+        return result;
+#endif
+    }
+
+    friend bool operator==(const Money& a, const Money& b) { return a.ticks_ == b.ticks_; }
+    friend bool operator!=(const Money& a, const Money& b) { return a.ticks_ != b.ticks_; }
+    friend bool operator<(const Money& a, const Money& b) { return a.ticks_ < b.ticks_; }
+
+private:
+    std::int64_t ticks_;
+    bool overflow_;
+
+    Money(std::int64_t ticks, bool overflow) : ticks_(ticks), overflow_(overflow) {}
+
+    // Each returns true on overflow
+#if defined(__GNUC__) || defined(__clang__)
+    static bool add(std::int64_t a, std::int64_t b, std::int64_t& out) { return __builtin_add_overflow(a, b, &out); }
+    static bool subtract(std::int64_t a, std::int64_t b, std::int64_t& out) { return __builtin_sub_overflow(a, b, &out); }
+    static bool multiply(std::int64_t a, std::int64_t b, std::int64_t& out) { return __builtin_mul_overflow(a, b, &out); }
+#else
+    static bool add(std::int64_t a, std::int64_t b, std::int64_t& out) {
+        if ((b > 0 && a > std::numeric_limits<std::int64_t>::max() - b) ||
+            (b < 0 && a < std::numeric_limits<std::int64_t>::min() - b)) return true;
+        out = a + b;
+        return false;
+    }
+    static bool subtract(std::int64_t a, std::int64_t b, std::int64_t& out) {
+        if ((b < 0 && a > std::numeric_limits<std::int64_t>::max() + b) ||
+            (b > 0 && a < std::numeric_limits<std::int64_t>::min() + b)) return true;
+        out = a - b;
+        return false;
+    }
+    static bool multiply(std::int64_t a, std::int64_t b, std::int64_t& out) {
+        if (a != 0 && b != 0) {
+            std::int64_t limit = std::numeric_limits<std::int64_t>::max();
+            bool negative = (a < 0) != (b < 0);
+            std::uint64_t ua = a < 0 ? 0 - static_cast<std::uint64_t>(a) : static_cast<std::uint64_t>(a);
+            std::uint64_t ub = b < 0 ? 0 - static_cast<std::uint64_t>(b) : static_cast<std::uint64_t>(b);
+            std::uint64_t bound = static_cast<std::uint64_t>(limit) + (negative ? 1 : 0);
+            if (ua > bound / ub) return true;
+        }
+        out = static_cast<std::int64_t>(static_cast<std::uint64_t>(a) * static_cast<std::uint64_t>(b));
+        return false;
+    }
+#endif
+};
+
+#endif // MONEY_H
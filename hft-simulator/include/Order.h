@@ -22,6 +22,7 @@ public:
     std::uint64_t getTimestamp() const;
     OrderType getOrderType() const;
     double getStopPrice() const;
+    int getOwnerID() const;
 
     // Mutators
     void setOrderID(int order_id);
@@ -31,6 +32,7 @@ public:
     void setTimestamp(std::uint64_t timestamp);
     void setOrderType(OrderType type);
     void setStopPrice(double stop_price);
+    void setOwnerID(int owner_id);
 
     // Utility
     static std::string sideToString(Side side);
@@ -44,6 +46,7 @@ private:
     std::uint64_t timestamp_;
     OrderType type_;
     double stop_price_; // Only used for STOP orders
+    int owner_id_;      // Submitting strategy/client, 0 if unowned
 };
 
 #endif // ORDER_H 
\ No newline at end of file
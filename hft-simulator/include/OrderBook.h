@@ -1,62 +1,41 @@
 #ifndef ORDERBOOK_H
 #define ORDERBOOK_H
 
-#include "Order.h"
+#include "BasicOrderBook.h"
+#include "HugePageArena.h"
 #include "TradeLogger.h"
-#include <map>
-#include <list>
-#include <unordered_map>
-#include <vector>
-#include <queue>
+#include <memory>
+
+// Policy set of the default book: telemetry counters, an optional event listener,
+// console/TradeLogger output, wall-clock timestamps, double price levels and pooled containers.
+using DefaultOrderBook = BasicOrderBook<TelemetrySink<ListenerSink<TradeLoggerSink>>, SystemClock, DoublePrice, PoolStorage>;
+
+// Instantiated once in OrderBook.cpp
+extern template class BasicOrderBook<TelemetrySink<ListenerSink<TradeLoggerSink>>, SystemClock, DoublePrice, PoolStorage>;
+
+// Arena owned by an OrderBook. A base listed before the book, so it is released only after
+// the book's containers have returned their nodes.
+struct OrderBookArena {
+    std::unique_ptr<HugePageArena> arena_;
+};
 
 // OrderBook manages buy and sell orders, supports add, match, cancel, market, and stop operations.
-class OrderBook {
+// Custom policy combinations can instantiate BasicOrderBook directly.
+class OrderBook : private OrderBookArena, public DefaultOrderBook {
 public:
     OrderBook();
 
-    // Add a new order to the book (limit or market)
-    void addOrder(const Order& order);
-    // Add a market order (executes immediately at best price)
-    void addMarketOrder(const Order& order);
-    // Add a stop order (activates when stop price is reached)
-    void addStopOrder(const Order& order);
-    // Attempt to match orders (buy vs sell). Matches best prices and logs trades if logger is set.
-    void matchOrders();
-    // Check and activate stop orders if price is reached
-    void checkStopOrders();
-    // Cancel an order by ID. Returns true if canceled, false if not found.
-    bool cancelOrder(int order_id);
-    // Get all current buy orders (for inspection/testing)
-    std::vector<Order> getBuyOrders() const;
-    // Get all current sell orders (for inspection/testing)
-    std::vector<Order> getSellOrders() const;
+    // Hand the book an arena to carve its pool nodes from (useChunkSource), e.g. one created
+    // on the engine thread's NUMA node. Kept for the book's lifetime; false, and the arena is
+    // released, if the book already has one or holds resting orders.
+    bool attachArena(std::unique_ptr<HugePageArena> arena);
+    HugePageArena* arena() const { return arena_.get(); }
+
     // Set the trade logger for recording matched trades
     void setTradeLogger(TradeLogger* logger);
-
-private:
-    // Buy orders: price descending (highest first)
-    std::map<double, std::list<Order>, std::greater<double>> buy_orders_;
-    // Sell orders: price ascending (lowest first)
-    std::map<double, std::list<Order>> sell_orders_;
-    // Fast lookup for canceling orders by ID
-    std::unordered_map<int, std::pair<Order::Side, std::pair<double, std::list<Order>::iterator>>> order_lookup_;
-
-    TradeLogger* trade_logger_ = nullptr;
-
-    // Priority queues for fast access to best prices
-    // These are updated on add/cancel for O(1) best price lookup
-    std::priority_queue<double> buy_price_pq_; // max-heap for buy prices
-    std::priority_queue<double, std::vector<double>, std::greater<double>> sell_price_pq_; // min-heap for sell prices
-
-    // Containers for pending stop orders
-    std::vector<Order> stop_buy_orders_;
-    std::vector<Order> stop_sell_orders_;
-
-    // Helper to remove order from book and lookup
-    void removeOrder(int order_id);
-
-    // Helper to maintain price priority queues
-    void updatePriceQueues();
+    // Subscribe a listener (e.g. StrategyEngine, OrderGateway) to fills and top-of-book state
+    void addEventListener(BookEventListener* listener);
+    void removeEventListener(BookEventListener* listener);
 };
 
-#endif // ORDERBOOK_H 
\ No newline at end of file
+#endif // ORDERBOOK_H
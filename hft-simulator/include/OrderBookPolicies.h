@@ -0,0 +1,244 @@
+#ifndef ORDERBOOKPOLICIES_H
+#define ORDERBOOKPOLICIES_H
+
+#include "Order.h"
+#include "PoolAllocator.h"
+#include "Telemetry.h"
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+class TradeLogger;
+
+// A single execution reported by the book to its event sink.
+struct Fill {
+    int buy_order_id;
+    int sell_order_id;
+    double price;
+    int quantity;
+    std::uint64_t timestamp;
+    Order::Side aggressor;
+    bool market_order; // true when produced by a market/stop sweep rather than matchOrders()
+    int buy_owner_id;
+    int sell_owner_id;
+};
+
+// New total resting quantity of one price level (market-by-price delta).
+struct LevelUpdate {
+    Order::Side side;
+    double price;
+    std::int64_t quantity; // 0 when the level is gone
+};
+
+// Top of book and sizes of the book's internal structures, reported at the end of every
+// mutating call, when the book is consistent and sinks may safely call back into it.
+struct BookState {
+    std::size_t buy_levels;
+    std::size_t sell_levels;
+    std::size_t resting_orders;
+    std::size_t pending_stops;
+    std::size_t buy_heap_size;  // includes stale entries not yet discarded
+    std::size_t sell_heap_size;
+    double best_bid;            // 0 when the side is empty
+    std::int64_t best_bid_quantity;
+    double best_ask;
+    std::int64_t best_ask_quantity;
+};
+
+// ---- Event sink policies ----
+
+// Discards every event. Sinks derive from this so they only override the hooks they need.
+struct NullEventSink {
+    void onFill(const Fill&) {}
+    void onOrderAdded(const Order&) {}
+    void onOrdersCancelled(std::size_t) {}
+    void onLevelChange(const LevelUpdate&) {}
+    void onBookState(const BookState&) {}
+    // A market order or activated stop ran out of liquidity; its unfilled quantity is dropped
+    void onRemainderDropped(int, int) {}
+};
+
+// Default sink: echoes each fill to the console and forwards it to a TradeLogger if one is set.
+class TradeLoggerSink : public NullEventSink {
+public:
+    void setLogger(TradeLogger* logger) { logger_ = logger; }
+    TradeLogger* logger() const { return logger_; }
+    void onFill(const Fill& fill);
+
+private:
+    TradeLogger* logger_ = nullptr;
+};
+
+// Runtime subscriber to book events, e.g. StrategyEngine dispatching to strategies or
+// OrderGateway reporting fills to its clients
+class BookEventListener {
+public:
+    virtual ~BookEventListener() {}
+    virtual void onFill(const Fill& fill) = 0;
+    virtual void onBookState(const BookState& state) = 0;
+    // Called mid-operation like onFill; listeners must not call back into the book here
+    virtual void onLevelChange(const LevelUpdate&) {}
+    // Mid-operation as well: order_id will never fill again, quantity of it went unfilled
+    virtual void onRemainderDropped(int /*order_id*/, int /*quantity*/) {}
+};
+
+// Forwards fills, level changes, book state and dropped remainders to Inner, then to each subscribed BookEventListener in
+// subscription order.
+template <class Inner>
+class ListenerSink : public Inner {
+public:
+    void addListener(BookEventListener* listener) { listeners_.push_back(listener); }
+    void removeListener(BookEventListener* listener) {
+        for (std::size_t i = 0; i < listeners_.size(); ++i) {
+            if (listeners_[i] == listener) {
+                listeners_.erase(listeners_.begin() + static_cast<std::ptrdiff_t>(i));
+                return;
+            }
+        }
+    }
+
+    void onFill(const Fill& fill) {
+        Inner::onFill(fill);
+        for (std::size_t i = 0; i < listeners_.size(); ++i) listeners_[i]->onFill(fill);
+    }
+    void onLevelChange(const LevelUpdate& update) {
+        Inner::onLevelChange(update);
+        for (std::size_t i = 0; i < listeners_.size(); ++i) listeners_[i]->onLevelChange(update);
+    }
+    void onBookState(const BookState& state) {
+        Inner::onBookState(state);
+        for (std::size_t i = 0; i < listeners_.size(); ++i) listeners_[i]->onBookState(state);
+    }
+    void onRemainderDropped(int order_id, int quantity) {
+        Inner::onRemainderDropped(order_id, quantity);
+        for (std::size_t i = 0; i < listeners_.size(); ++i) listeners_[i]->onRemainderDropped(order_id, quantity);
+    }
+
+private:
+    std::vector<BookEventListener*> listeners_;
+};
+
+// Counts book activity into the calling thread's telemetry slab, then forwards to Inner.
+// Book gauges are summed over every book; the sink remembers what its book last reported
+// so it only adds the change, and withdraws the lot when the book goes away.
+template <class Inner>
+class TelemetrySink : public Inner {
+public:
+    TelemetrySink() = default;
+    // A copy has not reported anything yet
+    TelemetrySink(const TelemetrySink& other) : Inner(other), reported_() {}
+    TelemetrySink& operator=(const TelemetrySink& other) {
+        Inner::operator=(other);
+        return *this;
+    }
+    ~TelemetrySink() { report(BookGauges()); }
+
+    void onFill(const Fill& fill) {
+        telemetryAdd(Metric::FILLS);
+        telemetryAdd(Metric::FILLED_QUANTITY, fill.quantity);
+        Inner::onFill(fill);
+    }
+    void onOrderAdded(const Order& order) {
+        telemetryAdd(Metric::ORDERS_ADDED);
+        Inner::onOrderAdded(order);
+    }
+    void onOrdersCancelled(std::size_t count) {
+        telemetryAdd(Metric::ORDERS_CANCELLED, static_cast<std::int64_t>(count));
+        Inner::onOrdersCancelled(count);
+    }
+    void onBookState(const BookState& state) {
+        BookGauges now;
+        now.values[0] = static_cast<std::int64_t>(state.buy_levels);
+        now.values[1] = static_cast<std::int64_t>(state.sell_levels);
+        now.values[2] = static_cast<std::int64_t>(state.resting_orders);
+        now.values[3] = static_cast<std::int64_t>(state.pending_stops);
+        now.values[4] = static_cast<std::int64_t>(state.buy_heap_size);
+        now.values[5] = static_cast<std::int64_t>(state.sell_heap_size);
+        report(now);
+        Inner::onBookState(state);
+    }
+
+private:
+    // BUY_LEVELS .. SELL_HEAP_SIZE, in Metric order
+    struct BookGauges {
+        static const std::size_t kCount = 6;
+        std::int64_t values[kCount] = {};
+    };
+    static_assert(static_cast<std::size_t>(Metric::SELL_HEAP_SIZE) - static_cast<std::size_t>(Metric::BUY_LEVELS) + 1 ==
+                  BookGauges::kCount, "book gauges are contiguous in Metric");
+    BookGauges reported_;
+
+    void report(const BookGauges& now) {
+        for (std::size_t i = 0; i < BookGauges::kCount; ++i) {
+            telemetryAdjust(static_cast<Metric>(static_cast<std::size_t>(Metric::BUY_LEVELS) + i), reported_.values[i], now.values[i]);
+        }
+        reported_ = now;
+    }
+};
+
+// ---- Clock policies ----
+
+// Wall clock; timestamps are raw system_clock ticks.
+struct SystemClock {
+    std::uint64_t now() const {
+        return static_cast<std::uint64_t>(std::chrono::system_clock::now().time_since_epoch().count());
+    }
+};
+
+// Manually advanced clock for deterministic backtests.
+class SimulatedClock {
+public:
+    std::uint64_t now() const { return now_; }
+    void advanceTo(std::uint64_t t) { now_ = t; }
+    void advanceBy(std::uint64_t dt) { now_ += dt; }
+
+private:
+    std::uint64_t now_ = 0;
+};
+
+// ---- Price representation policies ----
+
+// Levels keyed directly on the order's double price.
+struct DoublePrice {
+    using key_type = double;
+    static key_type toKey(double price) { return price; }
+    static double toPrice(key_type key) { return key; }
+};
+
+// Levels keyed on integer ticks, so prices that differ only by rounding share a level.
+template <std::int64_t TicksPerUnit = 100>
+struct TickPrice {
+    using key_type = std::int64_t;
+    static key_type toKey(double price) { return std::llround(price * TicksPerUnit); }
+    static double toPrice(key_type key) { return static_cast<double>(key) / TicksPerUnit; }
+};
+
+// ---- Order storage policies ----
+
+// Standard library containers with the default allocator.
+struct StdStorage {
+    template <class T>
+    using list = std::list<T>;
+    template <class K, class V, class Compare>
+    using map = std::map<K, V, Compare>;
+    template <class K, class V>
+    using hash_map = std::unordered_map<K, V>;
+};
+
+// Same containers with node allocations served from PoolAllocator free lists.
+struct PoolStorage {
+    template <class T>
+    using list = std::list<T, PoolAllocator<T>>;
+    template <class K, class V, class Compare>
+    using map = std::map<K, V, Compare, PoolAllocator<std::pair<const K, V>>>;
+    template <class K, class V>
+    using hash_map = std::unordered_map<K, V, std::hash<K>, std::equal_to<K>, PoolAllocator<std::pair<const K, V>>>;
+};
+
+#endif // ORDERBOOKPOLICIES_H
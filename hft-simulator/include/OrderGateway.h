@@ -0,0 +1,107 @@
+#ifndef ORDERGATEWAY_H
+#define ORDERGATEWAY_H
+
+#include "GatewayProtocol.h"
+#include "OrderBook.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// OrderGateway lets external processes trade against an OrderBook over the binary protocol
+// in GatewayProtocol.h, on a Unix domain socket and/or a localhost TCP port (Linux only).
+//
+// A single thread runs an epoll loop over the listening sockets and every client session.
+// Each round reads what the ready sessions have sent, decodes complete messages in place
+// in the session's receive buffer, applies them to the book, matches once, and then
+// flushes each session's queued acks and fills with a single send(). The gateway owns the
+// book while it runs: nothing else may touch the book from another thread.
+//
+// Every session gets its own owner ID, and the book gets gateway-assigned order IDs, so
+// client order IDs only need to be unique within a session. Closing a session cancels
+// all of its orders.
+class OrderGateway : private BookEventListener {
+public:
+    explicit OrderGateway(OrderBook& book, int first_order_id = 1000000, int first_owner_id = 1000000);
+    ~OrderGateway();
+
+    OrderGateway(const OrderGateway&) = delete;
+    OrderGateway& operator=(const OrderGateway&) = delete;
+
+    bool listenUnix(const std::string& path);
+    // Listens on 127.0.0.1; port 0 picks a free port, reported by tcpPort()
+    bool listenTcp(int port);
+    int tcpPort() const { return tcp_port_; }
+
+    // One round of the event loop, waiting up to timeout_ms for activity (-1 waits forever).
+    // Returns the number of ready descriptors handled.
+    int poll(int timeout_ms);
+    // Poll until stop()
+    void run();
+    // Ends run(); safe to call from another thread or a signal handler
+    void stop();
+
+    std::size_t sessionCount() const { return sessions_.size(); }
+    // Orders the gateway still reports fills for
+    std::size_t liveOrderCount() const { return live_.size(); }
+
+private:
+    static const std::size_t kReceiveBufferSize = 64 * 1024;
+
+    struct Session {
+        int fd;
+        int owner_id;
+        std::vector<char> in;   // kReceiveBufferSize bytes, of which in_used hold unread data
+        std::size_t in_used;
+        std::vector<char> out;  // encoded replies waiting for the next flush
+        bool want_write;        // EPOLLOUT registered after a short send
+        std::unordered_map<std::uint32_t, int> orders; // client order ID -> book order ID
+    };
+
+    // A live gateway order, keyed by book order ID
+    struct LiveOrder {
+        Session* session;
+        std::uint32_t client_order_id;
+        Order::Side side;
+        std::int64_t leaves;
+    };
+
+    OrderBook& book_;
+    int epoll_fd_;
+    int wake_fd_;
+    int unix_fd_;
+    int tcp_fd_;
+    int tcp_port_;
+    std::string unix_path_;
+    bool running_;
+    int next_order_id_;
+    int next_owner_id_;
+    std::unordered_map<int, std::unique_ptr<Session>> sessions_; // by fd
+    std::unordered_map<int, LiveOrder> live_;
+    std::vector<Session*> dirty_; // sessions with replies queued this round
+
+    bool addListener(int fd);
+    void accept(int listen_fd);
+    void read(Session& session);
+    // Decodes and applies complete messages; false on a protocol error
+    bool decode(Session& session);
+    void onNewOrder(Session& session, const GatewayNewOrder& msg);
+    void onCancel(Session& session, const GatewayCancel& msg);
+    void onAmend(Session& session, const GatewayAmend& msg);
+    void ack(Session& session, std::uint32_t client_order_id, int order_id, GatewayAckStatus status, std::int64_t leaves);
+    void reject(Session& session, std::uint32_t client_order_id, GatewayRejectReason reason);
+    template <class Message>
+    void queue(Session& session, const Message& msg);
+    void flush(Session& session);
+    void close(Session& session);
+    void forget(Session& session, std::uint32_t client_order_id);
+
+    void onFill(const Fill& fill) override;
+    void onBookState(const BookState&) override {}
+    void onRemainderDropped(int order_id, int quantity) override;
+    void fillLeg(int order_id, Order::Side side, const Fill& fill);
+};
+
+#endif // ORDERGATEWAY_H
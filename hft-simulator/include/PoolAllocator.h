@@ -0,0 +1,183 @@
+#ifndef POOLALLOCATOR_H
+#define POOLALLOCATOR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Raw memory for pool nodes, e.g. a HugePageArena on the engine's NUMA node. Containers
+// whose PoolAllocator is bound to a source carve their nodes from it, and their freed nodes
+// go back onto the source's own free lists, never to another container's pool, so nothing
+// outside those containers can hold a block of it once it is released.
+// The lists are not synchronised: a source serves one thread at a time (like a book).
+class ChunkSource {
+public:
+    virtual ~ChunkSource() {
+        for (std::size_t i = 0; i < fallback_.size(); ++i) {
+            ::operator delete(fallback_[i].first, std::align_val_t(fallback_[i].second));
+        }
+    }
+    // Returns nullptr once exhausted; nodes then come from operator new chunks kept until
+    // the source is destroyed
+    virtual void* allocateChunk(std::size_t bytes, std::size_t align) = 0;
+
+    void* allocateNode(std::size_t size, std::size_t align) {
+        NodeList& list = nodeList(size, align);
+        if (!list.free_list) refill(list);
+        FreeNode* node = list.free_list;
+        list.free_list = node->next;
+        return node;
+    }
+
+    void deallocateNode(void* p, std::size_t size, std::size_t align) {
+        NodeList& list = nodeList(size, align);
+        FreeNode* node = static_cast<FreeNode*>(p);
+        node->next = list.free_list;
+        list.free_list = node;
+    }
+
+private:
+    struct FreeNode {
+        FreeNode* next;
+    };
+
+    // One free list per node size; a pooled book uses a handful
+    struct NodeList {
+        std::size_t size;
+        std::size_t align;
+        FreeNode* free_list;
+        std::size_t next_chunk;
+    };
+
+    std::vector<NodeList> lists_;
+    std::vector<std::pair<void*, std::size_t>> fallback_; // operator new chunks and their alignment
+
+    NodeList& nodeList(std::size_t size, std::size_t align) {
+        align = std::max(align, alignof(FreeNode));
+        size = (std::max(size, sizeof(FreeNode)) + align - 1) / align * align;
+        for (std::size_t i = 0; i < lists_.size(); ++i) {
+            if (lists_[i].size == size && lists_[i].align == align) return lists_[i];
+        }
+        lists_.push_back(NodeList{size, align, nullptr, 64});
+        return lists_.back();
+    }
+
+    void refill(NodeList& list) {
+        std::size_t count = list.next_chunk;
+        unsigned char* chunk = static_cast<unsigned char*>(allocateChunk(list.size * count, list.align));
+        if (!chunk) {
+            chunk = static_cast<unsigned char*>(::operator new(list.size * count, std::align_val_t(list.align)));
+            fallback_.push_back(std::make_pair(static_cast<void*>(chunk), list.align));
+        }
+        for (std::size_t i = count; i-- > 0;) {
+            FreeNode* node = reinterpret_cast<FreeNode*>(chunk + i * list.size);
+            node->next = list.free_list;
+            list.free_list = node;
+        }
+        list.next_chunk = std::min<std::size_t>(count * 2, 65536);
+    }
+};
+
+// NodePool hands out fixed-size blocks from a per-thread free list.
+// Chunks grow geometrically and are never returned to the system, so a book
+// that has reached its steady-state size stops calling operator new entirely.
+template <std::size_t Size, std::size_t Align>
+class NodePool {
+public:
+    static void* allocate() {
+        State& s = state();
+        if (!s.free_list) refill(s);
+        Node* node = s.free_list;
+        s.free_list = node->next;
+        return node;
+    }
+
+    static void deallocate(void* p) {
+        State& s = state();
+        Node* node = static_cast<Node*>(p);
+        node->next = s.free_list;
+        s.free_list = node;
+    }
+
+private:
+    union Node {
+        Node* next;
+        alignas(Align) unsigned char storage[Size];
+    };
+
+    struct State {
+        Node* free_list = nullptr;
+        std::size_t next_chunk = 64;
+    };
+
+    static State& state() {
+        thread_local State s;
+        return s;
+    }
+
+    static void refill(State& s) {
+        std::size_t count = s.next_chunk;
+        void* memory = ::operator new(sizeof(Node) * count, std::align_val_t(alignof(Node)));
+        Node* chunk = static_cast<Node*>(memory);
+        for (std::size_t i = 0; i + 1 < count; ++i) {
+            chunk[i].next = &chunk[i + 1];
+        }
+        chunk[count - 1].next = s.free_list;
+        s.free_list = chunk;
+        s.next_chunk = std::min<std::size_t>(count * 2, 65536);
+    }
+};
+
+// Allocator for single-object allocations (list/map/hash nodes): from the thread's NodePool,
+// or from a ChunkSource when bound to one. Array allocations such as hash bucket tables
+// fall back to the global operator new. The source travels with the container on move
+// and swap, so nodes are always freed to the pool they came from.
+template <class T>
+class PoolAllocator {
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    using is_always_equal = std::false_type;
+
+    PoolAllocator() noexcept = default;
+    explicit PoolAllocator(ChunkSource* source) noexcept : source_(source) {}
+    template <class U>
+    PoolAllocator(const PoolAllocator<U>& other) noexcept : source_(other.source()) {}
+
+    ChunkSource* source() const noexcept { return source_; }
+
+    T* allocate(std::size_t n) {
+        if (n == 1) {
+            if (source_) return static_cast<T*>(source_->allocateNode(sizeof(T), alignof(T)));
+            return static_cast<T*>(NodePool<sizeof(T), alignof(T)>::allocate());
+        }
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+    }
+
+    void deallocate(T* p, std::size_t n) noexcept {
+        if (n == 1) {
+            if (source_) {
+                source_->deallocateNode(p, sizeof(T), alignof(T));
+            } else {
+                NodePool<sizeof(T), alignof(T)>::deallocate(p);
+            }
+            return;
+        }
+        ::operator delete(p, std::align_val_t(alignof(T)));
+    }
+
+    template <class U>
+    bool operator==(const PoolAllocator<U>& other) const noexcept { return source_ == other.source(); }
+    template <class U>
+    bool operator!=(const PoolAllocator<U>& other) const noexcept { return source_ != other.source(); }
+
+private:
+    ChunkSource* source_ = nullptr;
+};
+
+#endif // POOLALLOCATOR_H
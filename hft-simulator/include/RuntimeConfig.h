@@ -0,0 +1,37 @@
+#ifndef RUNTIMECONFIG_H
+#define RUNTIMECONFIG_H
+
+#include "LatencyModel.h"
+#include <cstddef>
+#include <string>
+
+// Thread and memory placement for production runs. Defaults reproduce the plain
+// single-threaded simulator: no engine thread, no pinning, no preallocated arena.
+struct RuntimeConfig {
+    bool engine_thread = false;  // StrategyEngine::start() runs the engine loop on its own thread
+    int matching_cpu = -1;       // CPU the engine (matching) thread is pinned to, -1 to leave unpinned
+    bool busy_poll = false;      // spin between ticks instead of sleeping for interval_ms
+    std::size_t arena_bytes = 0; // order pool arena preallocated by the engine thread, 0 for none
+    int numa_node = -1;          // arena node, -1 for the node of matching_cpu
+    bool huge_pages = true;      // back the arena with huge pages where available
+    bool prefault = true;        // touch every arena page at startup
+    std::string telemetry_socket;   // Unix socket serving telemetry snapshots, empty for none
+    std::string telemetry_file;     // file rewritten with telemetry every telemetry_interval_ms
+    int telemetry_interval_ms = 1000;
+    bool columnar_trades = false;   // write trades as a columnar store (trades.col) instead of trades.csv
+    std::string gateway_socket;     // Unix socket for the binary order-entry gateway, empty for none
+    int gateway_port = 0;           // localhost TCP port for the gateway, 0 for none
+    bool opening_auction = false;   // load the CSV orders into a call auction and uncross them at one price
+    std::string market_data_shm;    // /dev/shm region for top-of-book and trade/level broadcast, empty for none
+    // Strategy order entry and market data go through a LatencySimulator. Set by either
+    // order_entry_latency= or market_data_latency= ("<constant|uniform|normal|exponential>
+    // <base_ns> [jitter_ns]"); latency_tick_ns= and latency_seed= tune the simulator.
+    bool simulate_latency = false;
+    LatencyConfig latency;
+};
+
+// Parses key=value lines ('#' starts a comment) into a RuntimeConfig.
+// Missing files and unknown keys leave the defaults in place.
+RuntimeConfig loadRuntimeConfig(const std::string& filename);
+
+#endif // RUNTIMECONFIG_H
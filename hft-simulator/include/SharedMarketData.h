@@ -0,0 +1,106 @@
+#ifndef SHAREDMARKETDATA_H
+#define SHAREDMARKETDATA_H
+
+#include "OrderBookPolicies.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Shared-memory market data for local reader processes (Linux, /dev/shm/<name>).
+//
+// The region holds a seqlock-protected top-of-book snapshot and a broadcast ring of trades
+// and market-by-price level deltas. There is one writer and any number of readers. The
+// writer never waits for readers, and readers take no locks: they retry a read that raced
+// with the writer. Every ring record carries a sequence number. A reader that falls more
+// than a ring's worth behind sees a gap, skips to the oldest record still present and
+// counts the records it lost.
+
+// Latest best bid/ask as published by the book
+struct TopOfBookSnapshot {
+    std::uint64_t sequence; // number of top-of-book changes published so far
+    std::uint64_t timestamp;
+    double bid_price;       // 0 when the side is empty
+    std::int64_t bid_quantity;
+    double ask_price;
+    std::int64_t ask_quantity;
+};
+
+enum class BroadcastKind : std::uint8_t { TRADE = 1, LEVEL = 2 };
+
+// One ring record
+struct BroadcastRecord {
+    std::uint64_t sequence; // 1-based and gapless on the writer side
+    std::uint64_t timestamp;
+    double price;
+    std::int64_t quantity;  // trade size, or the level's new total (0: level removed)
+    BroadcastKind kind;
+    Order::Side side;       // aggressor for trades, level side for deltas
+    int buy_order_id;       // trades only
+    int sell_order_id;
+};
+
+// Writer side. Attach to the book as a BookEventListener; it publishes every fill, level
+// change and top-of-book change. Always creates a fresh region: an existing one under the
+// same name is unlinked first, so readers still mapping it keep a valid (stale) view
+// instead of faulting on a truncated file. Removes the region on destruction.
+class MarketDataPublisher : public BookEventListener {
+public:
+    // ring_capacity is rounded up to a power of two
+    explicit MarketDataPublisher(const std::string& name, std::size_t ring_capacity = 65536);
+    ~MarketDataPublisher() override;
+
+    MarketDataPublisher(const MarketDataPublisher&) = delete;
+    MarketDataPublisher& operator=(const MarketDataPublisher&) = delete;
+
+    bool isOpen() const { return region_ != nullptr; }
+    std::uint64_t published() const { return next_sequence_ - 1; }
+
+    void onFill(const Fill& fill) override;
+    void onLevelChange(const LevelUpdate& update) override;
+    void onBookState(const BookState& state) override;
+
+private:
+    std::string path_;
+    std::uint64_t device_; // identity of the object we created, so we never unlink a successor
+    std::uint64_t inode_;
+    char* region_;
+    std::size_t region_size_;
+    std::size_t capacity_;
+    std::uint64_t next_sequence_;
+    std::uint64_t top_sequence_;
+    TopOfBookSnapshot top_;
+
+    void publish(const BroadcastRecord& record);
+};
+
+// Reader side. Maps an existing region read-only.
+class MarketDataReader {
+public:
+    explicit MarketDataReader(const std::string& name);
+    ~MarketDataReader();
+
+    MarketDataReader(const MarketDataReader&) = delete;
+    MarketDataReader& operator=(const MarketDataReader&) = delete;
+
+    bool isOpen() const { return region_ != nullptr; }
+
+    // Consistent copy of the latest snapshot. Retries while the writer is mid-update, up to
+    // a bound; false (snapshot untouched) if the update never completes, e.g. the writer died.
+    bool topOfBook(TopOfBookSnapshot& snapshot) const;
+    // Next ring record; false when nothing is available right now (caught up, or the writer
+    // is overwriting the slot). Never waits. Starts from the oldest record still in the ring.
+    bool poll(BroadcastRecord& record);
+    // Skip everything already published
+    void seekToLatest();
+    // Records overwritten before this reader got to them
+    std::uint64_t lost() const { return lost_; }
+
+private:
+    const char* region_;
+    std::size_t region_size_;
+    std::size_t capacity_;
+    std::uint64_t next_;
+    std::uint64_t lost_;
+};
+
+#endif // SHAREDMARKETDATA_H
@@ -2,75 +2,194 @@
 #define STRATEGYENGINE_H
 
 #include "OrderBook.h"
+#include "LatencySimulator.h"
+#include "RuntimeConfig.h"
 #include <atomic>
 #include <chrono>
 #include <vector>
 #include <memory>
+#include <thread>
 
-// Base class for all strategies
+// Best bid and ask with the quantity resting at each; prices are 0 when a side is empty
+struct TopOfBook {
+    double bid_price;
+    std::int64_t bid_quantity;
+    double ask_price;
+    std::int64_t ask_quantity;
+};
+
+// An execution between any two orders in the book
+struct TradeEvent {
+    double price;
+    int quantity;
+    Order::Side aggressor;
+    std::uint64_t timestamp;
+};
+
+// An execution of one of the receiving strategy's own orders
+struct OwnFill {
+    int order_id;
+    Order::Side side;
+    double price;
+    int quantity;
+    std::uint64_t timestamp;
+};
+
+// Order entry as seen by a strategy. StrategyEngine implements it, sending straight to the
+// book or, with a LatencySimulator attached, after the simulated order-entry delay.
+class OrderSender {
+public:
+    virtual ~OrderSender() {}
+    virtual void sendOrder(int owner_id, const Order& order) = 0;
+    virtual void sendCancel(int owner_id, int order_id) = 0;
+    // Quantity resting ahead of an order, or -1 if it is not resting (filled, cancelled or
+    // still in flight)
+    virtual std::int64_t queuePosition(int order_id) const = 0;
+};
+
+// Base class for all strategies. Strategies react to book events rather than polling the
+// book; every callback defaults to a no-op, so a strategy only pays for what it overrides.
 class Strategy {
 public:
     virtual ~Strategy() {}
-    virtual void step() = 0; // Called each simulation tick
+    // Best bid/ask price or quantity changed (also called once when the strategy is added)
+    virtual void onTopOfBookChange(const TopOfBook&) {}
+    virtual void onTrade(const TradeEvent&) {}
+    // Fill of an order created with makeOrder()
+    virtual void onOwnFill(const OwnFill&) {}
+    // Called each engine tick, for strategies that also need a timer
+    virtual void step() {}
+
+    // Assigned by StrategyEngine::addStrategy; routes fills back to this strategy
+    int getOwnerID() const { return owner_id_; }
+    void setOwnerID(int owner_id) { owner_id_ = owner_id; }
+    void setOrderSender(OrderSender* sender) { sender_ = sender; }
+
+protected:
+    // Limit order stamped with the current time and tagged with this strategy's owner ID
+    Order makeOrder(int id, Order::Side side, double price, int qty) const;
+    // Order entry through the engine; ignored until the strategy has been added
+    void sendOrder(const Order& order);
+    void sendCancel(int order_id);
+    std::int64_t queuePosition(int order_id) const;
+
+private:
+    int owner_id_ = 0;
+    OrderSender* sender_ = nullptr;
 };
 
 // Market Making Strategy: Quotes both bid and ask around mid-price
 class MarketMakingStrategy : public Strategy {
 public:
-    MarketMakingStrategy(OrderBook& ob, double spread, int qty)
-        : order_book_(ob), spread_(spread), qty_(qty), order_id_(10000) {}
-    void step() override;
+    MarketMakingStrategy(double spread, int qty)
+        : spread_(spread), qty_(qty), order_id_(10000),
+          bid_id_(-1), ask_id_(-1), bid_price_(0.0), ask_price_(0.0), bid_open_(0), ask_open_(0) {}
+    void onTopOfBookChange(const TopOfBook& top) override;
+    void onOwnFill(const OwnFill& fill) override;
 private:
-    OrderBook& order_book_;
     double spread_;
     int qty_;
     int order_id_;
+    // Current quotes (-1 if none) and their unfilled quantity, tracked from own fills so a
+    // quote still in flight counts as open
+    int bid_id_;
+    int ask_id_;
+    double bid_price_;
+    double ask_price_;
+    int bid_open_;
+    int ask_open_;
+
+    // Keep the open quote if it is at the target price, or close to it and near the front
+    // of its queue; otherwise cancel it and quote again at the target.
+    void requote(int& quote_id, double& quote_price, int& open, Order::Side side, double target);
 };
 
-// Momentum Trading Strategy: Goes with short-term price trends
+// Momentum Trading Strategy: Goes with short-term trade price trends
 class MomentumStrategy : public Strategy {
 public:
-    MomentumStrategy(OrderBook& ob, int qty)
-        : order_book_(ob), qty_(qty), order_id_(20000), last_price_(0.0) {}
-    void step() override;
+    explicit MomentumStrategy(int qty)
+        : qty_(qty), order_id_(20000), last_price_(0.0) {}
+    void onTrade(const TradeEvent& trade) override;
 private:
-    OrderBook& order_book_;
     int qty_;
     int order_id_;
     double last_price_;
 };
 
-// Mean Reversion Strategy: Bets on return to mean using moving average
+// Mean Reversion Strategy: Bets on return to a moving average of trade prices
 class MeanReversionStrategy : public Strategy {
 public:
-    MeanReversionStrategy(OrderBook& ob, int qty, int window)
-        : order_book_(ob), qty_(qty), window_(window), order_id_(30000) {}
-    void step() override;
+    MeanReversionStrategy(int qty, int window)
+        : qty_(qty), window_(window), order_id_(30000) {}
+    void onTrade(const TradeEvent& trade) override;
 private:
-    OrderBook& order_book_;
     int qty_;
     int window_;
     int order_id_;
     std::vector<double> price_history_;
 };
 
-// StrategyEngine: Runs multiple strategies in sequence
-class StrategyEngine {
+// StrategyEngine: Owns the strategies, delivers book events to them and drives ticks.
+//
+// Once a strategy is added the engine subscribes to the book. Fills are queued as they
+// happen and delivered, together with any top-of-book change, when the book call that
+// produced them returns, so callbacks may safely call back into the book. Events caused
+// by those nested calls are delivered afterwards, in order, by the same outer dispatch.
+//
+// With a LatencySimulator attached, strategy orders and cancels reach the book after the
+// order-entry delay and every event reaches each strategy after its market-data delay;
+// both happen as simulated time advances.
+class StrategyEngine : private BookEventListener, private OrderSender {
 public:
     StrategyEngine(OrderBook& order_book, double spread, int interval_ms);
     ~StrategyEngine();
-    
+
+    // Strategies receive events and are stepped in the order they were added
+    void addStrategy(std::unique_ptr<Strategy> strategy);
+    // Thread placement, wait policy and memory used by start(). Set before start(). The
+    // arena is created on the engine thread and attached to the book, which keeps it.
+    void setRuntimeConfig(const RuntimeConfig& config);
+    // Route strategy order entry and event delivery through simulator (nullptr: direct).
+    // The simulator must drive this engine's book and outlive the engine's use of it.
+    void setLatencySimulator(LatencySimulator<OrderBook>* simulator);
+
+    // With engine_thread set, runs ticks on a dedicated (optionally pinned, busy-polling)
+    // thread until stop(). The book is single-writer, so strategies step and orders match
+    // on that one thread and callers must not touch the book while it runs.
     void start();
     void stop();
     bool isRunning() const;
+    // One tick: step every strategy, then match and activate stops. With a latency
+    // simulator, simulated time then advances by the tick interval.
     void run();
 
 private:
     OrderBook& order_book_;
     double spread_;
     int interval_ms_;
-    bool running_;
+    std::atomic<bool> running_;
     int next_order_id_;
+    RuntimeConfig config_;
+    std::vector<std::unique_ptr<Strategy>> strategies_;
+    LatencySimulator<OrderBook>* latency_;
+    std::thread thread_;
+    // Event dispatch state
+    std::vector<Fill> pending_fills_;
+    TopOfBook top_;
+    bool top_changed_;
+    bool dispatching_;
+
+    // Body of the engine thread
+    void loop();
+    void onFill(const Fill& fill) override;
+    void onBookState(const BookState& state) override;
+    void dispatch();
+    void deliver(const Fill& fill);
+    void deliverTop(const TopOfBook& top);
+    Strategy* strategyForOwner(int owner_id) const;
+    void sendOrder(int owner_id, const Order& order) override;
+    void sendCancel(int owner_id, int order_id) override;
+    std::int64_t queuePosition(int order_id) const override;
 };
 
 #endif // STRATEGYENGINE_H 
\ No newline at end of file
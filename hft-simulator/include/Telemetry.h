@@ -0,0 +1,119 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+// In-process telemetry. Each thread writes its own cache-line aligned slab of counters with
+// plain relaxed stores (one writer per slab, so no read-modify-write and no contention);
+// readers sum the slabs of every thread that has ever reported.
+//
+// Counters only grow. Gauges are single shared atomics, not per-thread sums. A gauge one
+// structure owns (the trade logger's) is set and the last writer wins, whichever thread
+// reports it. Book gauges are totals over every live book: each book adds the change in
+// its own reading, so several books (one per symbol in an ITCH replay) do not overwrite
+// each other, and a destroyed book takes its share back out.
+enum class Metric : std::size_t {
+    // Counters
+    ORDERS_ADDED,
+    ORDERS_CANCELLED,
+    FILLS,
+    FILLED_QUANTITY,
+    TRADES_LOGGED,
+    STRATEGY_STEPS,
+    // Gauges
+    BUY_LEVELS,
+    SELL_LEVELS,
+    RESTING_ORDERS,
+    PENDING_STOPS,
+    BUY_HEAP_SIZE,
+    SELL_HEAP_SIZE,
+    LOGGER_TRADES_HELD,
+    COUNT
+};
+
+const std::size_t kMetricCount = static_cast<std::size_t>(Metric::COUNT);
+// Counters come first in Metric; the rest are gauges
+const std::size_t kCounterCount = static_cast<std::size_t>(Metric::BUY_LEVELS);
+
+const char* metricName(Metric metric);
+bool metricIsGauge(Metric metric);
+
+struct alignas(64) TelemetrySlab {
+    std::atomic<std::int64_t> values[kCounterCount];
+};
+
+// Allocates and registers a slab for the calling thread (slabs outlive their threads)
+TelemetrySlab* registerTelemetrySlab();
+
+inline TelemetrySlab& telemetrySlab() {
+    thread_local TelemetrySlab* slab = nullptr;
+    if (!slab) slab = registerTelemetrySlab();
+    return *slab;
+}
+
+// Process-wide gauge values, indexed by metric - kCounterCount
+std::atomic<std::int64_t>* telemetryGauges();
+
+// Hot-path counter update: a thread-local load plus a relaxed store
+inline void telemetryAdd(Metric metric, std::int64_t n = 1) {
+    std::atomic<std::int64_t>& v = telemetrySlab().values[static_cast<std::size_t>(metric)];
+    v.store(v.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+// Gauge update: a relaxed store to the shared value
+inline void telemetrySet(Metric metric, std::int64_t value) {
+    telemetryGauges()[static_cast<std::size_t>(metric) - kCounterCount].store(value, std::memory_order_relaxed);
+}
+
+// Summed gauge update: one contributor's reading moved from `from` to `to`
+inline void telemetryAdjust(Metric metric, std::int64_t from, std::int64_t to) {
+    if (from == to) return;
+    telemetryGauges()[static_cast<std::size_t>(metric) - kCounterCount].fetch_add(to - from, std::memory_order_relaxed);
+}
+
+struct TelemetrySnapshot {
+    std::array<std::int64_t, kMetricCount> values{};
+    std::uint64_t taken_at_ns = 0; // steady clock
+
+    std::int64_t get(Metric metric) const { return values[static_cast<std::size_t>(metric)]; }
+};
+
+// Counters summed over every thread's slab, and the current gauges
+TelemetrySnapshot snapshotTelemetry();
+
+// Plain-text "name value" lines. With a previous snapshot, counters also get a
+// "<name>_per_sec" rate over the interval between the two.
+std::string formatTelemetry(const TelemetrySnapshot& current, const TelemetrySnapshot* previous = nullptr);
+
+// Serves snapshots from a background thread, either to clients of a Unix domain socket
+// (plain text, or an HTTP/1.0 response when the client sends a GET) or by rewriting a
+// file every interval.
+class TelemetryExporter {
+public:
+    TelemetryExporter();
+    ~TelemetryExporter();
+
+    TelemetryExporter(const TelemetryExporter&) = delete;
+    TelemetryExporter& operator=(const TelemetryExporter&) = delete;
+
+    bool startSocket(const std::string& path);
+    bool startFileDump(const std::string& path, int interval_ms);
+    void stop();
+    bool isRunning() const;
+
+private:
+    std::atomic<bool> running_;
+    std::thread thread_;
+    int listen_fd_;
+    std::string path_;
+
+    void serveSocket();
+    void dumpFile(int interval_ms);
+};
+
+#endif // TELEMETRY_H
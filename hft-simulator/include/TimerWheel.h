@@ -0,0 +1,222 @@
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+// TimerWheel is a hierarchical timing wheel (Varghese & Lauck) keyed on integer ticks.
+//
+// Four levels of 256 slots cover deadlines up to 2^32 ticks ahead; anything further out
+// waits in an overflow list until its 2^32 block comes round. An event is placed in the
+// lowest level whose block contains both now() and its deadline, and is cascaded one
+// level down each time time enters the block of its slot, so insert is O(1) and each
+// event is moved at most four times before it expires.
+//
+// Per-level occupancy bitmaps let advance() jump straight to the next non-empty slot,
+// so sparse schedules cost nothing per idle tick. Slot lists are FIFO, which keeps
+// events with the same deadline in the order they were scheduled.
+template <class T>
+class TimerWheel {
+public:
+    explicit TimerWheel(std::uint64_t start_tick = 0) : now_(start_tick) {}
+
+    // Schedule value to expire at tick `when`. Deadlines at or before now() expire on the
+    // next advance() call.
+    void schedule(std::uint64_t when, T value) {
+        std::uint32_t node = allocNode(when, std::move(value));
+        if (when <= now_) {
+            append(ready_, node);
+        } else {
+            place(node);
+        }
+        ++size_;
+    }
+
+    // Advance to tick `to`, calling on_expire(when, value) for every event with a deadline
+    // up to and including `to`, in deadline order. on_expire may schedule further events.
+    template <class Fn>
+    void advance(std::uint64_t to, Fn&& on_expire) {
+        drain(ready_, on_expire);
+        while (now_ < to) {
+            if (size_ == 0) {
+                now_ = to;
+                break;
+            }
+            std::uint64_t next = nextEventTick();
+            if (next > to) {
+                now_ = to;
+                break;
+            }
+            now_ = next;
+            cascade();
+            List& due = slots_[0][now_ & kSlotMask];
+            clearBit(0, now_ & kSlotMask);
+            List expired = due;
+            due = List();
+            drain(expired, on_expire);
+            drain(ready_, on_expire);
+        }
+    }
+
+    std::uint64_t now() const { return now_; }
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+
+private:
+    static const int kLevels = 4;
+    static const int kSlotBits = 8;
+    static const int kSlots = 1 << kSlotBits;
+    static const std::uint64_t kSlotMask = kSlots - 1;
+    static const int kWords = kSlots / 64;
+    static const std::uint32_t kNil = std::numeric_limits<std::uint32_t>::max();
+
+    struct Node {
+        T value;
+        std::uint64_t when;
+        std::uint32_t next;
+    };
+
+    struct List {
+        std::uint32_t head = kNil;
+        std::uint32_t tail = kNil;
+        bool empty() const { return head == kNil; }
+    };
+
+    std::uint64_t now_;
+    std::size_t size_ = 0;
+    std::vector<Node> nodes_;
+    std::uint32_t free_ = kNil;
+    List slots_[kLevels][kSlots];
+    std::uint64_t occupied_[kLevels][kWords] = {};
+    List ready_;    // deadlines already reached when scheduled
+    List overflow_; // deadlines beyond the top level
+    std::uint64_t overflow_min_ = std::numeric_limits<std::uint64_t>::max();
+
+    std::uint32_t allocNode(std::uint64_t when, T&& value) {
+        if (free_ != kNil) {
+            std::uint32_t node = free_;
+            free_ = nodes_[node].next;
+            nodes_[node].value = std::move(value);
+            nodes_[node].when = when;
+            nodes_[node].next = kNil;
+            return node;
+        }
+        nodes_.push_back(Node{std::move(value), when, kNil});
+        return static_cast<std::uint32_t>(nodes_.size() - 1);
+    }
+
+    void append(List& list, std::uint32_t node) {
+        nodes_[node].next = kNil;
+        if (list.tail == kNil) {
+            list.head = node;
+        } else {
+            nodes_[list.tail].next = node;
+        }
+        list.tail = node;
+    }
+
+    static int shift(int level) { return level * kSlotBits; }
+
+    // Put a node in the lowest level whose block contains both now_ and its deadline
+    void place(std::uint32_t node) {
+        std::uint64_t when = nodes_[node].when;
+        for (int level = 0; level < kLevels; ++level) {
+            int block_shift = shift(level + 1);
+            if ((when >> block_shift) == (now_ >> block_shift)) {
+                std::uint64_t slot = (when >> shift(level)) & kSlotMask;
+                append(slots_[level][slot], node);
+                setBit(level, slot);
+                return;
+            }
+        }
+        append(overflow_, node);
+        if (when < overflow_min_) overflow_min_ = when;
+    }
+
+    // Re-place the contents of every slot whose block starts at now_, top level first
+    void cascade() {
+        if ((now_ & ((std::uint64_t(1) << shift(kLevels)) - 1)) == 0 && !overflow_.empty()) {
+            List pending = overflow_;
+            overflow_ = List();
+            overflow_min_ = std::numeric_limits<std::uint64_t>::max();
+            relink(pending);
+        }
+        for (int level = kLevels - 1; level > 0; --level) {
+            if ((now_ & ((std::uint64_t(1) << shift(level)) - 1)) != 0) continue;
+            std::uint64_t slot = (now_ >> shift(level)) & kSlotMask;
+            List pending = slots_[level][slot];
+            if (pending.empty()) continue;
+            slots_[level][slot] = List();
+            clearBit(level, slot);
+            relink(pending);
+        }
+    }
+
+    void relink(List list) {
+        std::uint32_t node = list.head;
+        while (node != kNil) {
+            std::uint32_t next = nodes_[node].next;
+            place(node);
+            node = next;
+        }
+    }
+
+    template <class Fn>
+    void drain(List& list, Fn& on_expire) {
+        while (!list.empty()) {
+            std::uint32_t node = list.head;
+            list.head = nodes_[node].next;
+            if (list.head == kNil) list.tail = kNil;
+            std::uint64_t when = nodes_[node].when;
+            T value = std::move(nodes_[node].value);
+            nodes_[node].next = free_;
+            free_ = node;
+            --size_;
+            on_expire(when, value);
+        }
+    }
+
+    // Smallest tick after now_ at which a slot expires or cascades
+    std::uint64_t nextEventTick() const {
+        for (int level = 0; level < kLevels; ++level) {
+            std::uint64_t current = (now_ >> shift(level)) & kSlotMask;
+            int slot = nextSetBit(level, static_cast<int>(current) + 1);
+            if (slot >= 0) {
+                std::uint64_t block = now_ >> shift(level + 1) << shift(level + 1);
+                return block + (std::uint64_t(slot) << shift(level));
+            }
+        }
+        // Only far-future events remain: jump to the start of the earliest one's block
+        return overflow_min_ >> shift(kLevels) << shift(kLevels);
+    }
+
+    void setBit(int level, std::uint64_t slot) { occupied_[level][slot >> 6] |= std::uint64_t(1) << (slot & 63); }
+    void clearBit(int level, std::uint64_t slot) { occupied_[level][slot >> 6] &= ~(std::uint64_t(1) << (slot & 63)); }
+
+    int nextSetBit(int level, int from) const {
+        for (int w = from >> 6; w < kWords; ++w) {
+            std::uint64_t bits = occupied_[level][w];
+            if (w == (from >> 6)) bits &= ~std::uint64_t(0) << (from & 63);
+            if (bits) return (w << 6) + lowestBit(bits);
+        }
+        return -1;
+    }
+
+    static int lowestBit(std::uint64_t bits) {
+#if defined(__GNUC__) || defined(__clang__)
+        return __builtin_ctzll(bits);
+#else
+        int n = 0;
+        while (!(bits & 1)) {
+            bits >>= 1;
+            ++n;
+        }
+        return n;
+#endif
+    }
+};
+
+#endif // TIMERWHEEL_H
@@ -0,0 +1,106 @@
+#ifndef TRADEANALYTICS_H
+#define TRADEANALYTICS_H
+
+#include "ColumnarTradeStore.h"
+#include "Money.h"
+#include "Order.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Post-trade analytics over TradeLogger output, independent of a live logger.
+//
+// Fills are held column by column so every pass is a plain loop over arrays. Passes split
+// the fills into one contiguous chunk per thread, reduce each chunk on its own and combine
+// the partial results in chunk order. Notional, cash, equity and per-owner totals are summed
+// in exact Money, so they do not depend on the thread count.
+
+// Fills as columns, in log order
+struct TradeColumns {
+    std::vector<std::uint64_t> timestamp;
+    std::vector<std::int64_t> price_ticks; // Money ticks (1/kMoneyScale)
+    std::vector<std::int64_t> quantity;
+    std::vector<int> buy_order_id;
+    std::vector<int> sell_order_id;
+    std::vector<std::uint8_t> buy_aggressor;
+    std::vector<int> buy_owner_id;
+    std::vector<int> sell_owner_id;
+
+    std::size_t size() const { return price_ticks.size(); }
+    void resize(std::size_t n);
+    void append(const FillRecord& fill);
+};
+
+// TradeLogger CSV output. The CSV has no owner IDs (loaded as 0) and second-resolution
+// text timestamps, which are turned back into the clock ticks formatTimestamp() printed,
+// up to the local time zone offset. Stops at the appended summary. False if unreadable.
+bool loadTradesCSV(const std::string& filename, TradeColumns& trades);
+// Columnar store (TradeOutputFormat::COLUMNAR); chunks are decoded in parallel
+bool loadTradesColumnar(const std::string& filename, TradeColumns& trades, unsigned threads = 0);
+// Either format, told apart by the columnar magic
+bool loadTrades(const std::string& filename, TradeColumns& trades, unsigned threads = 0);
+
+// Account whose P&L and inventory are tracked: an owner ID, or this value to follow the
+// aggressor of every fill like TradeLogger's position does
+const int kAggressorAccount = -1;
+
+struct AnalyticsOptions {
+    std::uint64_t interval = 1000000000; // timestamp ticks per interval (1s of system_clock ns)
+    int account = kAggressorAccount;
+    unsigned threads = 0;                // 0: one per hardware thread
+};
+
+// One interval of the report; equity and inventory are the account's state at its end
+struct IntervalStats {
+    std::uint64_t start;  // first timestamp of the interval
+    std::uint64_t trades;
+    std::int64_t volume;
+    double vwap;          // 0 without trades
+    double equity;        // cash + inventory marked at the last trade price
+    std::int64_t inventory;
+};
+
+struct OwnerStats {
+    int owner_id;
+    std::uint64_t fills;
+    std::int64_t bought;
+    std::int64_t sold;
+    double notional;
+    // Cost against the VWAP of the fill's interval (truncated to a tick), in price units summed
+    // over quantity: positive when the owner bought above or sold below it. The logs carry no
+    // quotes, so interval VWAP stands in for the mid.
+    double slippage;
+};
+
+struct AnalyticsReport {
+    std::uint64_t fills = 0;
+    std::int64_t volume = 0;
+    double notional = 0.0;
+    std::uint64_t interval = 0; // as used; widened if the span needs too many intervals
+    double final_equity = 0.0;
+    std::int64_t final_inventory = 0;
+    double max_drawdown = 0.0;  // largest fall of equity from a running peak, fill by fill
+    double sharpe = 0.0;        // mean / stddev of per-interval equity changes (not annualised)
+    double sortino = 0.0;       // mean / downside deviation of the same changes
+    bool overflowed = false;    // an exact money total did not fit in 64-bit ticks
+    std::vector<IntervalStats> intervals; // every interval from the first fill to the last
+    std::vector<OwnerStats> owners;       // by owner ID
+};
+
+AnalyticsReport analyzeTrades(const TradeColumns& trades, const AnalyticsOptions& options = AnalyticsOptions());
+
+// How much of the submitted quantity of `orders` the fills executed (orders not in the list
+// are ignored)
+struct FillRatio {
+    std::uint64_t orders = 0;
+    std::uint64_t orders_filled = 0; // orders with at least one fill
+    std::int64_t submitted = 0;
+    std::int64_t filled = 0;
+
+    double ratio() const { return submitted > 0 ? static_cast<double>(filled) / submitted : 0.0; }
+};
+
+FillRatio computeFillRatio(const std::vector<Order>& orders, const TradeColumns& trades);
+
+#endif // TRADEANALYTICS_H
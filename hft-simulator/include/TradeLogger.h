@@ -3,6 +3,10 @@
 #include <fstream>
 #include <vector>
 #include <map>
+#include <memory>
+#include <cstdint>
+#include "ColumnarTradeStore.h"
+#include "Money.h"
 
 struct Trade {
     int buy_order_id;
@@ -11,57 +15,79 @@ struct Trade {
     int quantity;
     std::string timestamp;
     std::string aggressor_side;
+    std::uint64_t timestamp_raw = 0; // clock ticks behind `timestamp`
+    int buy_owner_id = 0;
+    int sell_owner_id = 0;
 };
 
+// CSV: one text row per trade plus an appended summary (default).
+// COLUMNAR: chunked, compressed columns readable with ColumnarTradeReader; no text summary.
+enum class TradeOutputFormat { CSV, COLUMNAR };
+
+// Position and P&L in exact Money. The open position is kept as its total cost rather than
+// an average price, so there is no division on the trade path: closing part of a position
+// releases its proportional share of the cost (truncated to a tick, with the remainder
+// staying in the basis), and a position that returns to flat has realized exactly the sum
+// of its cash flows.
 struct Position {
     int net_quantity = 0;
-    double average_price = 0.0;
-    double realized_pnl = 0.0;
-    double unrealized_pnl = 0.0;
-    
-    void update(int qty, double price, bool is_buy) {
+    Money cost_basis;     // paid for an open long, received for an open short
+    Money realized_pnl;
+    Money unrealized_pnl;
+
+    void update(int qty, Money price, bool is_buy) {
         if (is_buy) {
             if (net_quantity < 0) { // Covering short position
                 int cover_qty = std::min(qty, -net_quantity);
-                realized_pnl += (average_price - price) * cover_qty;
+                Money released = cost_basis.scaled(cover_qty, -net_quantity);
+                realized_pnl += released - price * cover_qty;
+                cost_basis -= released;
                 qty -= cover_qty;
                 net_quantity += cover_qty;
             }
             if (qty > 0) { // Building long position
-                double new_total = (average_price * net_quantity) + (price * qty);
+                cost_basis += price * qty;
                 net_quantity += qty;
-                average_price = new_total / net_quantity;
             }
         } else { // Selling
             if (net_quantity > 0) { // Closing long position
                 int close_qty = std::min(qty, net_quantity);
-                realized_pnl += (price - average_price) * close_qty;
+                Money released = cost_basis.scaled(close_qty, net_quantity);
+                realized_pnl += price * close_qty - released;
+                cost_basis -= released;
                 qty -= close_qty;
                 net_quantity -= close_qty;
             }
             if (qty > 0) { // Building short position
-                double new_total = (average_price * -net_quantity) + (price * qty);
+                cost_basis += price * qty;
                 net_quantity -= qty;
-                average_price = new_total / -net_quantity;
             }
         }
     }
-    
-    void mark_to_market(double mark_price) {
+
+    void mark_to_market(Money mark_price) {
         if (net_quantity > 0) {
-            unrealized_pnl = (mark_price - average_price) * net_quantity;
+            unrealized_pnl = mark_price * net_quantity - cost_basis;
         } else if (net_quantity < 0) {
-            unrealized_pnl = (average_price - mark_price) * -net_quantity;
+            unrealized_pnl = cost_basis - mark_price * -net_quantity;
         } else {
-            unrealized_pnl = 0.0;
+            unrealized_pnl = Money();
         }
     }
+
+    // For display only; 0 when flat
+    double average_price() const {
+        if (net_quantity == 0) return 0.0;
+        return cost_basis.toDouble() / (net_quantity > 0 ? net_quantity : -net_quantity);
+    }
 };
 
 class TradeLogger {
 public:
-    TradeLogger(const std::string& filename);
+    TradeLogger(const std::string& filename, TradeOutputFormat format = TradeOutputFormat::CSV);
     ~TradeLogger();
+
+    TradeOutputFormat format() const { return format_; }
     
     void logTrade(const Trade& trade);
     void printSummary() const;
@@ -74,14 +100,24 @@ public:
     int getNetPosition() const;
     double getAveragePrice() const;
     void updateMarkPrice(double price);
+    // Exact amounts behind the getters above
+    const Position& getPosition() const { return position_; }
+    Money getExactAggressorPnL() const { return aggressor_pnl_; }
 
 private:
+    TradeOutputFormat format_;
     std::ofstream file_;
+    std::unique_ptr<ColumnarTradeWriter> columnar_;
+    // Trades are retained in memory only in CSV mode; totals below cover both modes
     std::vector<Trade> trades_;
+    std::size_t trade_count_ = 0;
+    Money aggressor_pnl_;
     Position position_;
-    double last_mark_price_ = 0.0;
+    Money last_mark_price_;
     
     // Helper methods
+    // Any P&L total lost to 64-bit tick overflow; both summaries flag it
+    bool pnlOverflowed() const;
     void writePnLSummary();
-    void updatePosition(const Trade& trade);
+    void updatePosition(int quantity, Money price, bool is_buy);
 }; 
\ No newline at end of file
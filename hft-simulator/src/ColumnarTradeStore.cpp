@@ -0,0 +1,342 @@
+#include "ColumnarTradeStore.h"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <unordered_map>
+
+static const char kMagic[4] = {'H', 'F', 'T', 'C'};
+static const std::uint32_t kVersion = 1;
+
+// ---- Encoding helpers ----
+
+static void putFixed(std::vector<std::uint8_t>& out, std::uint64_t v, int bytes) {
+    for (int i = 0; i < bytes; ++i) out.push_back(static_cast<std::uint8_t>(v >> (8 * i)));
+}
+
+static std::uint64_t getFixed(const std::uint8_t* p, int bytes) {
+    std::uint64_t v = 0;
+    for (int i = 0; i < bytes; ++i) v |= static_cast<std::uint64_t>(p[i]) << (8 * i);
+    return v;
+}
+
+static void putVarint(std::vector<std::uint8_t>& out, std::uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<std::uint8_t>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t>(v));
+}
+
+// False when the data ends mid-varint or it runs past 64 bits
+static bool getVarint(const std::uint8_t*& p, const std::uint8_t* end, std::uint64_t& v) {
+    v = 0;
+    for (int shift = 0; p < end && shift < 64; shift += 7) {
+        std::uint8_t b = *p++;
+        v |= static_cast<std::uint64_t>(b & 0x7f) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+static std::uint64_t zigzag(std::int64_t v) {
+    return (static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63);
+}
+
+static std::int64_t unzigzag(std::uint64_t v) {
+    return static_cast<std::int64_t>(v >> 1) ^ -static_cast<std::int64_t>(v & 1);
+}
+
+enum class Encoding { DELTA, VARINT, BITMAP, DICTIONARY };
+
+static Encoding columnEncoding(TradeColumn column) {
+    switch (column) {
+        case TradeColumn::QUANTITY: return Encoding::VARINT;
+        case TradeColumn::AGGRESSOR: return Encoding::BITMAP;
+        case TradeColumn::BUY_OWNER_ID:
+        case TradeColumn::SELL_OWNER_ID: return Encoding::DICTIONARY;
+        default: return Encoding::DELTA;
+    }
+}
+
+static std::vector<std::uint8_t> encodeColumn(Encoding encoding, const std::vector<std::int64_t>& values) {
+    std::vector<std::uint8_t> out;
+    switch (encoding) {
+        case Encoding::DELTA: {
+            std::int64_t prev = 0;
+            for (std::size_t i = 0; i < values.size(); ++i) {
+                putVarint(out, zigzag(values[i] - prev));
+                prev = values[i];
+            }
+            break;
+        }
+        case Encoding::VARINT:
+            for (std::size_t i = 0; i < values.size(); ++i) putVarint(out, zigzag(values[i]));
+            break;
+        case Encoding::BITMAP:
+            out.assign((values.size() + 7) / 8, 0);
+            for (std::size_t i = 0; i < values.size(); ++i) {
+                if (values[i]) out[i / 8] |= static_cast<std::uint8_t>(1u << (i % 8));
+            }
+            break;
+        case Encoding::DICTIONARY: {
+            std::vector<std::int64_t> dictionary;
+            std::unordered_map<std::int64_t, std::uint64_t> index;
+            std::vector<std::uint64_t> codes;
+            codes.reserve(values.size());
+            for (std::size_t i = 0; i < values.size(); ++i) {
+                std::unordered_map<std::int64_t, std::uint64_t>::iterator it = index.find(values[i]);
+                if (it == index.end()) {
+                    it = index.emplace(values[i], dictionary.size()).first;
+                    dictionary.push_back(values[i]);
+                }
+                codes.push_back(it->second);
+            }
+            putVarint(out, dictionary.size());
+            for (std::size_t i = 0; i < dictionary.size(); ++i) putVarint(out, zigzag(dictionary[i]));
+            for (std::size_t i = 0; i < codes.size(); ++i) putVarint(out, codes[i]);
+            break;
+        }
+    }
+    return out;
+}
+
+// Decodes exactly `rows` values from a block, or fails. Every value takes at least one
+// byte (one bit in a bitmap), so a row count the block cannot hold is rejected before
+// anything is allocated for it.
+static bool decodeColumn(Encoding encoding, const std::vector<std::uint8_t>& bytes, std::uint32_t rows,
+                         std::vector<std::int64_t>& values) {
+    values.clear();
+    std::size_t min_bytes = encoding == Encoding::BITMAP ? (static_cast<std::size_t>(rows) + 7) / 8 : rows;
+    if (bytes.size() < min_bytes) return false;
+    values.reserve(rows);
+    const std::uint8_t* p = bytes.data();
+    const std::uint8_t* end = p + bytes.size();
+    std::uint64_t v;
+    switch (encoding) {
+        case Encoding::DELTA: {
+            std::int64_t prev = 0;
+            for (std::uint32_t i = 0; i < rows; ++i) {
+                if (!getVarint(p, end, v)) return false;
+                prev += unzigzag(v);
+                values.push_back(prev);
+            }
+            break;
+        }
+        case Encoding::VARINT:
+            for (std::uint32_t i = 0; i < rows; ++i) {
+                if (!getVarint(p, end, v)) return false;
+                values.push_back(unzigzag(v));
+            }
+            break;
+        case Encoding::BITMAP:
+            for (std::uint32_t i = 0; i < rows; ++i) {
+                values.push_back((bytes[i / 8] >> (i % 8)) & 1);
+            }
+            break;
+        case Encoding::DICTIONARY: {
+            // Each entry takes at least a byte, and so does each code after them
+            if (!getVarint(p, end, v) || v > static_cast<std::uint64_t>(end - p)) return false;
+            std::vector<std::int64_t> dictionary(static_cast<std::size_t>(v));
+            for (std::size_t i = 0; i < dictionary.size(); ++i) {
+                if (!getVarint(p, end, v)) return false;
+                dictionary[i] = unzigzag(v);
+            }
+            for (std::uint32_t i = 0; i < rows; ++i) {
+                if (!getVarint(p, end, v) || v >= dictionary.size()) return false;
+                values.push_back(dictionary[v]);
+            }
+            break;
+        }
+    }
+    return true;
+}
+
+// ---- Writer ----
+
+ColumnarTradeWriter::ColumnarTradeWriter(const std::string& filename, std::size_t chunk_rows, std::int64_t price_scale)
+    : file_(filename, std::ios::binary | std::ios::trunc), chunk_rows_(chunk_rows > 0 ? chunk_rows : 1),
+      price_scale_(price_scale > 0 ? price_scale : 1) {
+    if (!file_.is_open()) {
+        std::cerr << "Failed to open file: " << filename << std::endl;
+        return;
+    }
+    std::vector<std::uint8_t> header(kMagic, kMagic + 4);
+    putFixed(header, kVersion, 4);
+    putFixed(header, static_cast<std::uint64_t>(price_scale_), 8);
+    writeBytes(header);
+    for (std::size_t c = 0; c < kTradeColumnCount; ++c) columns_[c].reserve(chunk_rows_);
+}
+
+ColumnarTradeWriter::~ColumnarTradeWriter() {
+    close();
+}
+
+void ColumnarTradeWriter::append(const FillRecord& record) {
+    if (!file_.is_open()) return;
+    columns_[static_cast<std::size_t>(TradeColumn::TIMESTAMP)].push_back(static_cast<std::int64_t>(record.timestamp));
+    columns_[static_cast<std::size_t>(TradeColumn::PRICE)].push_back(std::llround(record.price * price_scale_));
+    columns_[static_cast<std::size_t>(TradeColumn::QUANTITY)].push_back(record.quantity);
+    columns_[static_cast<std::size_t>(TradeColumn::BUY_ORDER_ID)].push_back(record.buy_order_id);
+    columns_[static_cast<std::size_t>(TradeColumn::SELL_ORDER_ID)].push_back(record.sell_order_id);
+    columns_[static_cast<std::size_t>(TradeColumn::AGGRESSOR)].push_back(record.buy_aggressor ? 1 : 0);
+    columns_[static_cast<std::size_t>(TradeColumn::BUY_OWNER_ID)].push_back(record.buy_owner_id);
+    columns_[static_cast<std::size_t>(TradeColumn::SELL_OWNER_ID)].push_back(record.sell_owner_id);
+    ++rows_written_;
+    if (columns_[0].size() >= chunk_rows_) flushChunk();
+}
+
+void ColumnarTradeWriter::flushChunk() {
+    if (columns_[0].empty()) return;
+    TradeChunkInfo info;
+    info.rows = static_cast<std::uint32_t>(columns_[0].size());
+    for (std::size_t c = 0; c < kTradeColumnCount; ++c) {
+        std::vector<std::int64_t>& values = columns_[c];
+        std::vector<std::uint8_t> block = encodeColumn(columnEncoding(static_cast<TradeColumn>(c)), values);
+        std::pair<std::vector<std::int64_t>::iterator, std::vector<std::int64_t>::iterator> range =
+            std::minmax_element(values.begin(), values.end());
+        info.columns[c].offset = offset_;
+        info.columns[c].bytes = static_cast<std::uint32_t>(block.size());
+        info.columns[c].min = *range.first;
+        info.columns[c].max = *range.second;
+        writeBytes(block);
+        values.clear();
+    }
+    chunks_.push_back(info);
+}
+
+void ColumnarTradeWriter::close() {
+    if (!file_.is_open()) return;
+    flushChunk();
+    std::uint64_t footer_offset = offset_;
+    std::vector<std::uint8_t> footer;
+    putFixed(footer, chunks_.size(), 4);
+    for (std::size_t i = 0; i < chunks_.size(); ++i) {
+        putFixed(footer, chunks_[i].rows, 4);
+        for (std::size_t c = 0; c < kTradeColumnCount; ++c) {
+            putFixed(footer, chunks_[i].columns[c].offset, 8);
+            putFixed(footer, chunks_[i].columns[c].bytes, 4);
+            putFixed(footer, static_cast<std::uint64_t>(chunks_[i].columns[c].min), 8);
+            putFixed(footer, static_cast<std::uint64_t>(chunks_[i].columns[c].max), 8);
+        }
+    }
+    putFixed(footer, footer_offset, 8);
+    footer.insert(footer.end(), kMagic, kMagic + 4);
+    writeBytes(footer);
+    file_.close();
+}
+
+void ColumnarTradeWriter::writeBytes(const std::vector<std::uint8_t>& bytes) {
+    file_.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    offset_ += bytes.size();
+}
+
+// ---- Reader ----
+
+static const std::size_t kColumnEntryBytes = 8 + 4 + 8 + 8;
+
+ColumnarTradeReader::ColumnarTradeReader(const std::string& filename) : file_(filename, std::ios::binary) {
+    if (!file_.is_open()) {
+        std::cerr << "Failed to open file: " << filename << std::endl;
+        return;
+    }
+    std::uint8_t header[16];
+    if (!file_.read(reinterpret_cast<char*>(header), sizeof(header)) || !std::equal(kMagic, kMagic + 4, header)) return;
+    std::int64_t price_scale = static_cast<std::int64_t>(getFixed(header + 8, 8));
+    if (getFixed(header + 4, 4) != kVersion || price_scale <= 0) return;
+    price_scale_ = price_scale;
+    std::uint8_t trailer[12];
+    file_.seekg(-12, std::ios::end);
+    std::streamoff file_end = static_cast<std::streamoff>(file_.tellg()) + 12;
+    if (!file_.read(reinterpret_cast<char*>(trailer), sizeof(trailer)) || !std::equal(kMagic, kMagic + 4, trailer + 8)) return;
+    std::uint64_t footer_offset = getFixed(trailer, 8);
+    // The footer (at least its chunk count) lies between the header and the trailer
+    std::uint64_t footer_end = static_cast<std::uint64_t>(file_end - 12);
+    if (footer_offset < sizeof(header) || footer_end < 4 || footer_offset > footer_end - 4) return;
+    std::vector<std::uint8_t> footer(static_cast<std::size_t>(footer_end - footer_offset));
+    file_.seekg(static_cast<std::streamoff>(footer_offset));
+    if (!file_.read(reinterpret_cast<char*>(footer.data()), static_cast<std::streamsize>(footer.size()))) return;
+    const std::uint8_t* p = footer.data();
+    std::uint32_t count = static_cast<std::uint32_t>(getFixed(p, 4));
+    p += 4;
+    if (footer.size() != 4 + static_cast<std::size_t>(count) * (4 + kTradeColumnCount * kColumnEntryBytes)) return;
+    chunks_.resize(count);
+    for (std::uint32_t i = 0; i < count; ++i) {
+        chunks_[i].rows = static_cast<std::uint32_t>(getFixed(p, 4));
+        p += 4;
+        for (std::size_t c = 0; c < kTradeColumnCount; ++c) {
+            chunks_[i].columns[c].offset = getFixed(p, 8);
+            chunks_[i].columns[c].bytes = static_cast<std::uint32_t>(getFixed(p + 8, 4));
+            chunks_[i].columns[c].min = static_cast<std::int64_t>(getFixed(p + 12, 8));
+            chunks_[i].columns[c].max = static_cast<std::int64_t>(getFixed(p + 20, 8));
+            p += kColumnEntryBytes;
+            // Column data sits between the header and the footer
+            const ColumnChunkInfo& info = chunks_[i].columns[c];
+            if (info.offset < sizeof(header) || info.offset > footer_offset || info.bytes > footer_offset - info.offset) {
+                chunks_.clear();
+                return;
+            }
+        }
+        // Every row takes at least a byte of the timestamp block, which bounds what a reader
+        // of the row count may allocate
+        if (chunks_[i].rows > chunks_[i].column(TradeColumn::TIMESTAMP).bytes) {
+            chunks_.clear();
+            return;
+        }
+    }
+    valid_ = true;
+}
+
+std::uint64_t ColumnarTradeReader::rowCount() const {
+    std::uint64_t rows = 0;
+    for (std::size_t i = 0; i < chunks_.size(); ++i) rows += chunks_[i].rows;
+    return rows;
+}
+
+std::vector<std::int64_t> ColumnarTradeReader::readColumn(std::size_t chunk, TradeColumn column) {
+    if (!valid_ || chunk >= chunks_.size()) return std::vector<std::int64_t>();
+    const ColumnChunkInfo& info = chunks_[chunk].column(column);
+    std::vector<std::uint8_t> bytes(info.bytes);
+    file_.clear();
+    file_.seekg(static_cast<std::streamoff>(info.offset));
+    std::vector<std::int64_t> values;
+    if (!file_.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size())) ||
+        !decodeColumn(columnEncoding(column), bytes, chunks_[chunk].rows, values)) {
+        values.clear();
+    }
+    return values;
+}
+
+std::vector<std::size_t> ColumnarTradeReader::chunksInRange(TradeColumn column, std::int64_t low, std::int64_t high) const {
+    std::vector<std::size_t> result;
+    for (std::size_t i = 0; i < chunks_.size(); ++i) {
+        const ColumnChunkInfo& info = chunks_[i].column(column);
+        if (info.max >= low && info.min <= high) result.push_back(i);
+    }
+    return result;
+}
+
+std::vector<FillRecord> ColumnarTradeReader::readRows(std::size_t chunk) {
+    std::vector<FillRecord> rows;
+    if (!valid_ || chunk >= chunks_.size()) return rows;
+    std::size_t n = chunks_[chunk].rows;
+    std::vector<std::int64_t> columns[kTradeColumnCount];
+    for (std::size_t c = 0; c < kTradeColumnCount; ++c) {
+        columns[c] = readColumn(chunk, static_cast<TradeColumn>(c));
+        // A corrupt block fails the whole chunk
+        if (columns[c].size() != n) return rows;
+    }
+    rows.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        FillRecord r;
+        r.timestamp = static_cast<std::uint64_t>(columns[static_cast<std::size_t>(TradeColumn::TIMESTAMP)][i]);
+        r.price = ticksToPrice(columns[static_cast<std::size_t>(TradeColumn::PRICE)][i]);
+        r.quantity = static_cast<int>(columns[static_cast<std::size_t>(TradeColumn::QUANTITY)][i]);
+        r.buy_order_id = static_cast<int>(columns[static_cast<std::size_t>(TradeColumn::BUY_ORDER_ID)][i]);
+        r.sell_order_id = static_cast<int>(columns[static_cast<std::size_t>(TradeColumn::SELL_ORDER_ID)][i]);
+        r.buy_aggressor = columns[static_cast<std::size_t>(TradeColumn::AGGRESSOR)][i] != 0;
+        r.buy_owner_id = static_cast<int>(columns[static_cast<std::size_t>(TradeColumn::BUY_OWNER_ID)][i]);
+        r.sell_owner_id = static_cast<int>(columns[static_cast<std::size_t>(TradeColumn::SELL_OWNER_ID)][i]);
+        rows.push_back(r);
+    }
+    return rows;
+}
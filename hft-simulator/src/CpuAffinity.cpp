@@ -0,0 +1,45 @@
+#include "CpuAffinity.h"
+#include <string>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/stat.h>
+#endif
+
+bool pinCurrentThread(int cpu) {
+#ifdef __linux__
+    if (cpu < 0 || cpu >= CPU_SETSIZE) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+int currentCpu() {
+#ifdef __linux__
+    return sched_getcpu();
+#else
+    return -1;
+#endif
+}
+
+int numaNodeOfCpu(int cpu) {
+#ifdef __linux__
+    if (cpu < 0) return -1;
+    // The cpuN directory links to its node as nodeK
+    std::string base = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/node";
+    for (int node = 0; node < 1024; ++node) {
+        struct stat st;
+        if (stat((base + std::to_string(node)).c_str(), &st) == 0) return node;
+    }
+    return 0;
+#else
+    (void)cpu;
+    return -1;
+#endif
+}
@@ -0,0 +1,91 @@
+#include "HugePageArena.h"
+#include <cstdint>
+#include <new>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+static const std::size_t kHugePageSize = std::size_t(2) << 20;
+
+#ifdef __linux__
+// Bind a range to one node without depending on libnuma
+static bool bindToNode(void* addr, std::size_t len, int node) {
+#ifdef SYS_mbind
+    const int kMpolBind = 2;
+    const unsigned long kBitsPerWord = sizeof(unsigned long) * 8;
+    unsigned long mask[1024 / (sizeof(unsigned long) * 8)] = {};
+    if (node < 0 || node >= 1024) return false;
+    mask[node / kBitsPerWord] = 1UL << (node % kBitsPerWord);
+    return syscall(SYS_mbind, addr, len, kMpolBind, mask, 1024UL, 0U) == 0;
+#else
+    (void)addr; (void)len; (void)node;
+    return false;
+#endif
+}
+#endif
+
+HugePageArena::HugePageArena(std::size_t bytes, int numa_node, bool huge_pages, bool prefault) {
+    capacity_ = (bytes + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+    if (capacity_ == 0) return;
+#ifdef __linux__
+    void* p = MAP_FAILED;
+#ifdef MAP_HUGETLB
+    if (huge_pages) {
+        p = mmap(nullptr, capacity_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        huge_pages_ = p != MAP_FAILED;
+    }
+#endif
+    if (p == MAP_FAILED) {
+        p = mmap(nullptr, capacity_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+#ifdef MADV_HUGEPAGE
+        // No reserved huge pages: ask for transparent ones instead
+        if (p != MAP_FAILED && huge_pages) madvise(p, capacity_, MADV_HUGEPAGE);
+#endif
+    }
+    if (p != MAP_FAILED) {
+        base_ = static_cast<unsigned char*>(p);
+        mapped_ = true;
+        if (numa_node >= 0) numa_bound_ = bindToNode(base_, capacity_, numa_node);
+    }
+#else
+    (void)numa_node;
+    (void)huge_pages;
+#endif
+    if (!base_) {
+        base_ = static_cast<unsigned char*>(::operator new(capacity_, std::align_val_t(64)));
+    }
+    if (prefault) {
+        // Touch after binding so every page is faulted in on the chosen node
+        for (std::size_t off = 0; off < capacity_; off += 4096) {
+            base_[off] = 0;
+        }
+    }
+}
+
+HugePageArena::~HugePageArena() {
+    if (!base_) return;
+#ifdef __linux__
+    if (mapped_) {
+        munmap(base_, capacity_);
+        return;
+    }
+#endif
+    ::operator delete(base_, std::align_val_t(64));
+}
+
+void* HugePageArena::allocate(std::size_t bytes, std::size_t align) {
+    std::uintptr_t start = reinterpret_cast<std::uintptr_t>(base_) + used_;
+    std::uintptr_t aligned = (start + align - 1) & ~(static_cast<std::uintptr_t>(align) - 1);
+    std::size_t offset = static_cast<std::size_t>(aligned - reinterpret_cast<std::uintptr_t>(base_));
+    if (!base_ || offset + bytes > capacity_) return nullptr;
+    used_ = offset + bytes;
+    return base_ + offset;
+}
+
+bool HugePageArena::contains(const void* p) const {
+    const unsigned char* c = static_cast<const unsigned char*>(p);
+    return base_ && c >= base_ && c < base_ + capacity_;
+}
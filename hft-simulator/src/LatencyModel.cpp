@@ -0,0 +1,33 @@
+#include "LatencyModel.h"
+#include <cmath>
+
+LatencyModel::LatencyModel(const LatencyConfig& config) : config_(config), rng_(config.seed) {}
+
+std::uint64_t LatencyModel::orderEntryDelay() {
+    return sample(config_.order_entry);
+}
+
+std::uint64_t LatencyModel::marketDataDelay() {
+    return sample(config_.market_data);
+}
+
+std::uint64_t LatencyModel::sample(const LatencyDistribution& dist) {
+    double delay = static_cast<double>(dist.base_ns);
+    if (dist.jitter_ns > 0.0) {
+        switch (dist.kind) {
+            case LatencyDistribution::Kind::CONSTANT:
+                break;
+            case LatencyDistribution::Kind::UNIFORM:
+                delay += std::uniform_real_distribution<double>(0.0, dist.jitter_ns)(rng_);
+                break;
+            case LatencyDistribution::Kind::NORMAL:
+                delay += std::normal_distribution<double>(0.0, dist.jitter_ns)(rng_);
+                break;
+            case LatencyDistribution::Kind::EXPONENTIAL:
+                delay += std::exponential_distribution<double>(1.0 / dist.jitter_ns)(rng_);
+                break;
+        }
+    }
+    // Normal jitter can pull the sample below zero; a message never arrives before it is sent
+    return delay > 0.0 ? static_cast<std::uint64_t>(std::llround(delay)) : 0;
+}
@@ -0,0 +1,48 @@
+#include "MappedFile.h"
+#include <fstream>
+#include <iterator>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::string& filename) {
+#ifdef __linux__
+    int fd = open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return;
+    struct stat st;
+    if (fstat(fd, &st) == 0) {
+        size_ = static_cast<std::size_t>(st.st_size);
+        if (size_ == 0) {
+            open_empty_ = true;
+        } else {
+            void* p = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+            if (p != MAP_FAILED) {
+                madvise(p, size_, MADV_SEQUENTIAL);
+                data_ = static_cast<const char*>(p);
+                mapped_ = true;
+            } else {
+                size_ = 0;
+            }
+        }
+    }
+    // The mapping stays valid after the descriptor is closed
+    close(fd);
+#else
+    std::ifstream in(filename, std::ios::binary);
+    if (!in) return;
+    buffer_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    size_ = buffer_.size();
+    data_ = buffer_.data();
+    open_empty_ = buffer_.empty();
+#endif
+}
+
+MappedFile::~MappedFile() {
+#ifdef __linux__
+    if (mapped_) munmap(const_cast<char*>(data_), size_);
+#endif
+}
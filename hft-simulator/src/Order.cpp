@@ -1,10 +1,10 @@
 #include "Order.h"
 
 Order::Order(int order_id, Side side, double price, int quantity, std::uint64_t timestamp, OrderType type)
-    : order_id_(order_id), side_(side), price_(price), quantity_(quantity), timestamp_(timestamp), type_(type), stop_price_(0.0) {}
+    : order_id_(order_id), side_(side), price_(price), quantity_(quantity), timestamp_(timestamp), type_(type), stop_price_(0.0), owner_id_(0) {}
 
 Order::Order(int order_id, Side side, double price, int quantity, std::uint64_t timestamp, double stop_price)
-    : order_id_(order_id), side_(side), price_(price), quantity_(quantity), timestamp_(timestamp), type_(OrderType::STOP), stop_price_(stop_price) {}
+    : order_id_(order_id), side_(side), price_(price), quantity_(quantity), timestamp_(timestamp), type_(OrderType::STOP), stop_price_(stop_price), owner_id_(0) {}
 
 // Accessors
 int Order::getOrderID() const { return order_id_; }
@@ -14,6 +14,7 @@ int Order::getQuantity() const { return quantity_; }
 std::uint64_t Order::getTimestamp() const { return timestamp_; }
 Order::OrderType Order::getOrderType() const { return type_; }
 double Order::getStopPrice() const { return stop_price_; }
+int Order::getOwnerID() const { return owner_id_; }
 
 // Mutators
 void Order::setOrderID(int order_id) { order_id_ = order_id; }
@@ -23,6 +24,7 @@ void Order::setQuantity(int quantity) { quantity_ = quantity; }
 void Order::setTimestamp(std::uint64_t timestamp) { timestamp_ = timestamp; }
 void Order::setOrderType(OrderType type) { type_ = type; }
 void Order::setStopPrice(double stop_price) { stop_price_ = stop_price; }
+void Order::setOwnerID(int owner_id) { owner_id_ = owner_id; }
 
 // Utility
 std::string Order::sideToString(Side side) {
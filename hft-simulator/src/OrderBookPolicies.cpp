@@ -0,0 +1,24 @@
+#include "OrderBookPolicies.h"
+#include <iostream>
+#include "TradeLogger.h"
+#include "Utils.h"
+
+void TradeLoggerSink::onFill(const Fill& fill) {
+    std::cout << (fill.market_order ? "[MarketOrder] BuyOrder " : "Trade: BuyOrder ") << fill.buy_order_id
+              << " & SellOrder " << fill.sell_order_id
+              << ", Qty: " << fill.quantity << ", Price: " << fill.price << std::endl;
+    if (logger_) {
+        Trade trade;
+        trade.buy_order_id = fill.buy_order_id;
+        trade.sell_order_id = fill.sell_order_id;
+        trade.price = fill.price;
+        trade.quantity = fill.quantity;
+        // The columnar store keeps raw ticks, so skip formatting for it
+        if (logger_->format() == TradeOutputFormat::CSV) trade.timestamp = formatTimestamp(fill.timestamp);
+        trade.aggressor_side = Order::sideToString(fill.aggressor);
+        trade.timestamp_raw = fill.timestamp;
+        trade.buy_owner_id = fill.buy_owner_id;
+        trade.sell_owner_id = fill.sell_owner_id;
+        logger_->logTrade(trade);
+    }
+}
@@ -0,0 +1,444 @@
+#include "OrderGateway.h"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <cerrno>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+static double wireToPrice(std::int64_t price) {
+    return static_cast<double>(price) / kGatewayPriceScale;
+}
+
+static std::int64_t priceToWire(double price) {
+    return std::llround(price * kGatewayPriceScale);
+}
+
+static GatewaySide toWire(Order::Side side) {
+    return side == Order::Side::BUY ? GatewaySide::BUY : GatewaySide::SELL;
+}
+
+OrderGateway::OrderGateway(OrderBook& book, int first_order_id, int first_owner_id)
+    : book_(book), epoll_fd_(-1), wake_fd_(-1), unix_fd_(-1), tcp_fd_(-1), tcp_port_(0), running_(false),
+      next_order_id_(first_order_id), next_owner_id_(first_owner_id) {
+#ifdef __linux__
+    epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+    wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epoll_fd_ >= 0 && wake_fd_ >= 0) addListener(wake_fd_);
+#endif
+    book_.addEventListener(this);
+}
+
+OrderGateway::~OrderGateway() {
+    while (!sessions_.empty()) {
+        close(*sessions_.begin()->second);
+    }
+    book_.removeEventListener(this);
+#ifdef __linux__
+    if (unix_fd_ >= 0) {
+        ::close(unix_fd_);
+        unlink(unix_path_.c_str());
+    }
+    if (tcp_fd_ >= 0) ::close(tcp_fd_);
+    if (wake_fd_ >= 0) ::close(wake_fd_);
+    if (epoll_fd_ >= 0) ::close(epoll_fd_);
+#endif
+}
+
+bool OrderGateway::listenUnix(const std::string& path) {
+#ifdef __linux__
+    sockaddr_un addr = {};
+    if (unix_fd_ >= 0 || epoll_fd_ < 0 || path.size() >= sizeof(addr.sun_path)) return false;
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return false;
+    addr.sun_family = AF_UNIX;
+    path.copy(addr.sun_path, path.size());
+    unlink(path.c_str());
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(fd, 64) != 0 || !addListener(fd)) {
+        std::cerr << "[OrderGateway] Failed to listen on " << path << std::endl;
+        ::close(fd);
+        return false;
+    }
+    unix_fd_ = fd;
+    unix_path_ = path;
+    return true;
+#else
+    (void)path;
+    return false;
+#endif
+}
+
+bool OrderGateway::listenTcp(int port) {
+#ifdef __linux__
+    if (tcp_fd_ >= 0 || epoll_fd_ < 0) return false;
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return false;
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(static_cast<std::uint16_t>(port));
+    socklen_t len = sizeof(addr);
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(fd, 64) != 0 ||
+        getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len) != 0 || !addListener(fd)) {
+        std::cerr << "[OrderGateway] Failed to listen on 127.0.0.1:" << port << std::endl;
+        ::close(fd);
+        return false;
+    }
+    tcp_fd_ = fd;
+    tcp_port_ = ntohs(addr.sin_port);
+    return true;
+#else
+    (void)port;
+    return false;
+#endif
+}
+
+bool OrderGateway::addListener(int fd) {
+#ifdef __linux__
+    epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.fd = fd;
+    return epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev) == 0;
+#else
+    (void)fd;
+    return false;
+#endif
+}
+
+int OrderGateway::poll(int timeout_ms) {
+#ifdef __linux__
+    if (epoll_fd_ < 0) return 0;
+    epoll_event events[64];
+    int n = epoll_wait(epoll_fd_, events, 64, timeout_ms);
+    if (n <= 0) return 0;
+    for (int i = 0; i < n; ++i) {
+        int fd = events[i].data.fd;
+        if (fd == wake_fd_) {
+            std::uint64_t count;
+            while (::read(wake_fd_, &count, sizeof(count)) > 0) {}
+            running_ = false;
+        } else if (fd == unix_fd_ || fd == tcp_fd_) {
+            accept(fd);
+        } else {
+            std::unordered_map<int, std::unique_ptr<Session>>::iterator it = sessions_.find(fd);
+            if (it == sessions_.end()) continue; // closed earlier this round
+            if (events[i].events & EPOLLOUT) {
+                flush(*it->second);
+                // A failed send closes and frees the session (peer reset with a write pending)
+                it = sessions_.find(fd);
+                if (it == sessions_.end()) continue;
+            }
+            if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) read(*it->second);
+        }
+    }
+    // One matching pass for everything this round delivered, then batched replies
+    book_.matchOrders();
+    book_.checkStopOrders();
+    std::vector<Session*> dirty;
+    dirty.swap(dirty_);
+    for (std::size_t i = 0; i < dirty.size(); ++i) {
+        flush(*dirty[i]);
+    }
+    return n;
+#else
+    (void)timeout_ms;
+    return 0;
+#endif
+}
+
+void OrderGateway::run() {
+    running_ = true;
+    while (running_) {
+        poll(-1);
+    }
+}
+
+void OrderGateway::stop() {
+#ifdef __linux__
+    // eventfd write is async-signal-safe and wakes a blocked epoll_wait
+    std::uint64_t one = 1;
+    if (wake_fd_ >= 0) {
+        ssize_t ignored = ::write(wake_fd_, &one, sizeof(one));
+        (void)ignored;
+    }
+#endif
+}
+
+void OrderGateway::accept(int listen_fd) {
+#ifdef __linux__
+    for (;;) {
+        int fd = accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return;
+        if (listen_fd == tcp_fd_) {
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        }
+        epoll_event ev = {};
+        ev.events = EPOLLIN;
+        ev.data.fd = fd;
+        if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &ev) != 0) {
+            ::close(fd);
+            continue;
+        }
+        std::unique_ptr<Session> session(new Session);
+        session->fd = fd;
+        session->owner_id = next_owner_id_++;
+        session->in.resize(kReceiveBufferSize);
+        session->in_used = 0;
+        session->want_write = false;
+        sessions_[fd] = std::move(session);
+    }
+#else
+    (void)listen_fd;
+#endif
+}
+
+void OrderGateway::read(Session& session) {
+#ifdef __linux__
+    ssize_t n = recv(session.fd, session.in.data() + session.in_used, session.in.size() - session.in_used, 0);
+    if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+        close(session);
+        return;
+    }
+    if (n < 0) return;
+    session.in_used += static_cast<std::size_t>(n);
+    if (!decode(session)) close(session);
+#else
+    (void)session;
+#endif
+}
+
+bool OrderGateway::decode(Session& session) {
+    const char* data = session.in.data();
+    std::size_t offset = 0;
+    while (session.in_used - offset >= sizeof(GatewayHeader)) {
+        const GatewayHeader* header = reinterpret_cast<const GatewayHeader*>(data + offset);
+        std::size_t size = gatewayInboundSize(header->type);
+        if (size == 0 || header->length != size) return false;
+        if (session.in_used - offset < size) break;
+        // Messages are read where they landed; only a trailing partial message is moved
+        switch (header->type) {
+        case GatewayMessageType::NEW_ORDER:
+            onNewOrder(session, *reinterpret_cast<const GatewayNewOrder*>(data + offset));
+            break;
+        case GatewayMessageType::CANCEL:
+            onCancel(session, *reinterpret_cast<const GatewayCancel*>(data + offset));
+            break;
+        default:
+            onAmend(session, *reinterpret_cast<const GatewayAmend*>(data + offset));
+            break;
+        }
+        offset += size;
+    }
+    if (offset > 0) {
+        std::memmove(session.in.data(), data + offset, session.in_used - offset);
+        session.in_used -= offset;
+    }
+    return true;
+}
+
+void OrderGateway::onNewOrder(Session& session, const GatewayNewOrder& msg) {
+    bool valid_side = msg.side == GatewaySide::BUY || msg.side == GatewaySide::SELL;
+    bool valid_type = msg.order_type == GatewayOrderType::LIMIT || msg.order_type == GatewayOrderType::MARKET ||
+                      msg.order_type == GatewayOrderType::STOP;
+    // The book reads a limit order's price and a stop's trigger price; nothing else
+    bool valid_price = msg.order_type != GatewayOrderType::LIMIT || msg.price > 0;
+    bool valid_stop = msg.order_type != GatewayOrderType::STOP || msg.stop_price > 0;
+    if (!valid_side || !valid_type || !valid_price || !valid_stop || msg.quantity == 0 || msg.quantity > INT_MAX) {
+        reject(session, msg.client_order_id, GatewayRejectReason::INVALID_FIELDS);
+        return;
+    }
+    if (session.orders.count(msg.client_order_id)) {
+        reject(session, msg.client_order_id, GatewayRejectReason::DUPLICATE_ID);
+        return;
+    }
+    Order::Side side = msg.side == GatewaySide::BUY ? Order::Side::BUY : Order::Side::SELL;
+    int quantity = static_cast<int>(msg.quantity);
+    int order_id = next_order_id_++;
+    std::uint64_t ts = book_.clock().now();
+    Order order = msg.order_type == GatewayOrderType::STOP
+        ? Order(order_id, side, wireToPrice(msg.price), quantity, ts, wireToPrice(msg.stop_price))
+        : Order(order_id, side, wireToPrice(msg.price), quantity, ts,
+                msg.order_type == GatewayOrderType::MARKET ? Order::OrderType::MARKET : Order::OrderType::LIMIT);
+    order.setOwnerID(session.owner_id);
+
+    // Registered and acked first: a market order fills inside addOrder. Market orders and
+    // stops stay live until filled or until the book drops their remainder, so fills after
+    // a stop activates or an auction uncrosses are still reported.
+    session.orders[msg.client_order_id] = order_id;
+    live_[order_id] = LiveOrder{&session, msg.client_order_id, side, quantity};
+    ack(session, msg.client_order_id, order_id, GatewayAckStatus::ACCEPTED, quantity);
+    book_.addOrder(order);
+}
+
+void OrderGateway::onCancel(Session& session, const GatewayCancel& msg) {
+    std::unordered_map<std::uint32_t, int>::iterator it = session.orders.find(msg.client_order_id);
+    if (it == session.orders.end()) {
+        reject(session, msg.client_order_id, GatewayRejectReason::UNKNOWN_ORDER);
+        return;
+    }
+    int order_id = it->second;
+    std::int64_t leaves = live_[order_id].leaves;
+    // Dropped either way: an order the book no longer has is not live. Pending stops and
+    // held market orders are cancelled by the book as well.
+    forget(session, msg.client_order_id);
+    if (!book_.cancelOrder(order_id)) {
+        reject(session, msg.client_order_id, GatewayRejectReason::UNKNOWN_ORDER);
+        return;
+    }
+    ack(session, msg.client_order_id, order_id, GatewayAckStatus::CANCELLED, leaves);
+}
+
+void OrderGateway::onAmend(Session& session, const GatewayAmend& msg) {
+    if (msg.price <= 0 || msg.quantity == 0 || msg.quantity > INT_MAX) {
+        reject(session, msg.client_order_id, GatewayRejectReason::INVALID_FIELDS);
+        return;
+    }
+    std::unordered_map<std::uint32_t, int>::iterator it = session.orders.find(msg.client_order_id);
+    if (it == session.orders.end()) {
+        reject(session, msg.client_order_id, GatewayRejectReason::UNKNOWN_ORDER);
+        return;
+    }
+    Order::Side side = live_[it->second].side;
+    // Only resting limit orders can be replaced; a pending stop is not in the book's levels
+    if (book_.queuePosition(it->second) < 0 || !book_.cancelOrder(it->second)) {
+        reject(session, msg.client_order_id, GatewayRejectReason::UNKNOWN_ORDER);
+        return;
+    }
+    forget(session, msg.client_order_id);
+    int quantity = static_cast<int>(msg.quantity);
+    int order_id = next_order_id_++;
+    Order order(order_id, side, wireToPrice(msg.price), quantity, book_.clock().now(), Order::OrderType::LIMIT);
+    order.setOwnerID(session.owner_id);
+    session.orders[msg.client_order_id] = order_id;
+    live_[order_id] = LiveOrder{&session, msg.client_order_id, side, quantity};
+    ack(session, msg.client_order_id, order_id, GatewayAckStatus::AMENDED, quantity);
+    book_.addOrder(order);
+}
+
+void OrderGateway::ack(Session& session, std::uint32_t client_order_id, int order_id, GatewayAckStatus status,
+                       std::int64_t leaves) {
+    GatewayAck msg = {};
+    msg.header.length = sizeof(msg);
+    msg.header.type = GatewayMessageType::ACK;
+    msg.client_order_id = client_order_id;
+    msg.order_id = static_cast<std::uint32_t>(order_id);
+    msg.status = status;
+    msg.leaves = static_cast<std::uint32_t>(std::max<std::int64_t>(leaves, 0));
+    queue(session, msg);
+}
+
+void OrderGateway::reject(Session& session, std::uint32_t client_order_id, GatewayRejectReason reason) {
+    GatewayReject msg = {};
+    msg.header.length = sizeof(msg);
+    msg.header.type = GatewayMessageType::REJECT;
+    msg.client_order_id = client_order_id;
+    msg.reason = reason;
+    queue(session, msg);
+}
+
+template <class Message>
+void OrderGateway::queue(Session& session, const Message& msg) {
+    if (session.out.empty() && !session.want_write) dirty_.push_back(&session);
+    const char* bytes = reinterpret_cast<const char*>(&msg);
+    session.out.insert(session.out.end(), bytes, bytes + sizeof(msg));
+}
+
+void OrderGateway::flush(Session& session) {
+#ifdef __linux__
+    std::size_t sent = 0;
+    while (sent < session.out.size()) {
+        ssize_t n = send(session.fd, session.out.data() + sent, session.out.size() - sent, MSG_NOSIGNAL);
+        if (n > 0) {
+            sent += static_cast<std::size_t>(n);
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        } else {
+            close(session);
+            return;
+        }
+    }
+    session.out.erase(session.out.begin(), session.out.begin() + static_cast<std::ptrdiff_t>(sent));
+    // Socket full: wait for EPOLLOUT instead of spinning; stop waiting once drained
+    bool want_write = !session.out.empty();
+    if (want_write != session.want_write) {
+        epoll_event ev = {};
+        ev.events = EPOLLIN | (want_write ? EPOLLOUT : 0u);
+        ev.data.fd = session.fd;
+        epoll_ctl(epoll_fd_, EPOLL_CTL_MOD, session.fd, &ev);
+        session.want_write = want_write;
+    }
+#else
+    session.out.clear();
+#endif
+}
+
+void OrderGateway::close(Session& session) {
+    for (std::unordered_map<std::uint32_t, int>::iterator it = session.orders.begin(); it != session.orders.end(); ++it) {
+        live_.erase(it->second);
+    }
+    session.orders.clear();
+    // Cancel on disconnect; there is no one left to tell
+    book_.cancelAll(session.owner_id);
+    dirty_.erase(std::remove(dirty_.begin(), dirty_.end(), &session), dirty_.end());
+    int fd = session.fd;
+#ifdef __linux__
+    epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+    ::close(fd);
+#endif
+    sessions_.erase(fd);
+}
+
+void OrderGateway::forget(Session& session, std::uint32_t client_order_id) {
+    std::unordered_map<std::uint32_t, int>::iterator it = session.orders.find(client_order_id);
+    if (it == session.orders.end()) return;
+    live_.erase(it->second);
+    session.orders.erase(it);
+}
+
+void OrderGateway::onFill(const Fill& fill) {
+    fillLeg(fill.buy_order_id, Order::Side::BUY, fill);
+    fillLeg(fill.sell_order_id, Order::Side::SELL, fill);
+}
+
+void OrderGateway::onRemainderDropped(int order_id, int quantity) {
+    std::unordered_map<int, LiveOrder>::iterator it = live_.find(order_id);
+    if (it == live_.end()) return;
+    Session& session = *it->second.session;
+    std::uint32_t client_order_id = it->second.client_order_id;
+    forget(session, client_order_id);
+    ack(session, client_order_id, order_id, GatewayAckStatus::EXPIRED, quantity);
+}
+
+void OrderGateway::fillLeg(int order_id, Order::Side side, const Fill& fill) {
+    std::unordered_map<int, LiveOrder>::iterator it = live_.find(order_id);
+    if (it == live_.end()) return;
+    LiveOrder& live = it->second;
+    live.leaves -= fill.quantity;
+    GatewayFill msg = {};
+    msg.header.length = sizeof(msg);
+    msg.header.type = GatewayMessageType::FILL;
+    msg.client_order_id = live.client_order_id;
+    msg.side = toWire(side);
+    msg.price = priceToWire(fill.price);
+    msg.quantity = static_cast<std::uint32_t>(fill.quantity);
+    msg.leaves = static_cast<std::uint32_t>(std::max<std::int64_t>(live.leaves, 0));
+    msg.timestamp = fill.timestamp;
+    queue(*live.session, msg);
+    if (live.leaves <= 0) forget(*live.session, live.client_order_id);
+}
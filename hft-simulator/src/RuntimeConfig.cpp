@@ -0,0 +1,73 @@
+#include "RuntimeConfig.h"
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+static std::string trim(const std::string& s) {
+    std::size_t first = s.find_first_not_of(" \t\r");
+    if (first == std::string::npos) return "";
+    std::size_t last = s.find_last_not_of(" \t\r");
+    return s.substr(first, last - first + 1);
+}
+
+static bool parseBool(const std::string& value) {
+    return value == "1" || value == "true" || value == "yes" || value == "on";
+}
+
+// "<kind> <base_ns> [jitter_ns]", e.g. "normal 20000 1500"
+static LatencyDistribution parseLatency(const std::string& value) {
+    std::istringstream in(value);
+    std::string kind;
+    LatencyDistribution dist;
+    if (!(in >> kind >> dist.base_ns)) throw std::invalid_argument(value);
+    if (!(in >> dist.jitter_ns)) dist.jitter_ns = 0.0;
+    if (kind == "constant") dist.kind = LatencyDistribution::Kind::CONSTANT;
+    else if (kind == "uniform") dist.kind = LatencyDistribution::Kind::UNIFORM;
+    else if (kind == "normal") dist.kind = LatencyDistribution::Kind::NORMAL;
+    else if (kind == "exponential") dist.kind = LatencyDistribution::Kind::EXPONENTIAL;
+    else throw std::invalid_argument(kind);
+    if (dist.jitter_ns < 0.0) throw std::invalid_argument(value);
+    return dist;
+}
+
+RuntimeConfig loadRuntimeConfig(const std::string& filename) {
+    RuntimeConfig config;
+    std::ifstream file(filename);
+    if (!file.is_open()) return config;
+    std::string line;
+    while (std::getline(file, line)) {
+        std::size_t comment = line.find('#');
+        if (comment != std::string::npos) line.erase(comment);
+        std::size_t eq = line.find('=');
+        if (eq == std::string::npos) continue;
+        std::string key = trim(line.substr(0, eq));
+        std::string value = trim(line.substr(eq + 1));
+        try {
+            if (key == "engine_thread") config.engine_thread = parseBool(value);
+            else if (key == "matching_cpu") config.matching_cpu = std::stoi(value);
+            else if (key == "busy_poll") config.busy_poll = parseBool(value);
+            else if (key == "arena_mb") config.arena_bytes = static_cast<std::size_t>(std::stoull(value)) << 20;
+            else if (key == "numa_node") config.numa_node = std::stoi(value);
+            else if (key == "huge_pages") config.huge_pages = parseBool(value);
+            else if (key == "prefault") config.prefault = parseBool(value);
+            else if (key == "telemetry_socket") config.telemetry_socket = value;
+            else if (key == "telemetry_file") config.telemetry_file = value;
+            else if (key == "telemetry_interval_ms") config.telemetry_interval_ms = std::stoi(value);
+            else if (key == "trade_output") config.columnar_trades = (value == "columnar");
+            else if (key == "gateway_socket") config.gateway_socket = value;
+            else if (key == "gateway_port") config.gateway_port = std::stoi(value);
+            else if (key == "opening_auction") config.opening_auction = parseBool(value);
+            else if (key == "market_data_shm") config.market_data_shm = value;
+            else if (key == "order_entry_latency") config.latency.order_entry = parseLatency(value);
+            else if (key == "market_data_latency") config.latency.market_data = parseLatency(value);
+            else if (key == "latency_tick_ns") config.latency.tick_ns = std::stoull(value);
+            else if (key == "latency_seed") config.latency.seed = std::stoull(value);
+            // Only reached when the distribution parsed
+            if (key == "order_entry_latency" || key == "market_data_latency") config.simulate_latency = true;
+        } catch (const std::exception&) {
+            std::cerr << "Ignoring invalid runtime setting: " << key << "=" << value << std::endl;
+        }
+    }
+    return config;
+}
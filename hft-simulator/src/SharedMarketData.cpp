@@ -0,0 +1,309 @@
+#include "SharedMarketData.h"
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <new>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Region layout, one cache line per part so the writer's cursor and snapshot stores do
+// not share lines with each other or with the header readers poll:
+//   [RegionHeader][SeqlockTop][RingCursor][RingSlot x capacity]
+static const std::uint64_t kRegionMagic = 0x3130444d53544648ULL; // "HFTSMD01"
+static const std::size_t kTopWords = 6;
+static const std::size_t kRecordWords = 5;
+// How long one snapshot update may stay in progress before the writer is taken to have
+// died mid-update. A live writer only stays there this long if it is descheduled.
+static const std::chrono::milliseconds kTopStallLimit(50);
+
+struct alignas(64) RegionHeader {
+    std::atomic<std::uint64_t> magic; // stored last by the writer, so readers never see a half-built region
+    std::uint64_t capacity;
+    std::uint64_t record_words;
+};
+
+// Even sequence: stable; odd: the writer is mid-update
+struct alignas(64) SeqlockTop {
+    std::atomic<std::uint64_t> sequence;
+    std::atomic<std::uint64_t> words[kTopWords];
+};
+
+struct alignas(64) RingCursor {
+    std::atomic<std::uint64_t> write_sequence; // last record fully written
+};
+
+// sequence is the record number stored in the slot, or 0 while it is being rewritten
+struct alignas(64) RingSlot {
+    std::atomic<std::uint64_t> sequence;
+    std::atomic<std::uint64_t> words[kRecordWords];
+};
+
+static_assert(sizeof(RegionHeader) == 64 && sizeof(SeqlockTop) == 64 && sizeof(RingCursor) == 64 &&
+              sizeof(RingSlot) == 64, "shared region layout");
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "shared atomics must be address-free");
+
+static const std::size_t kTopOffset = sizeof(RegionHeader);
+static const std::size_t kCursorOffset = kTopOffset + sizeof(SeqlockTop);
+static const std::size_t kSlotsOffset = kCursorOffset + sizeof(RingCursor);
+
+static std::size_t regionSize(std::size_t capacity) {
+    return kSlotsOffset + capacity * sizeof(RingSlot);
+}
+
+static std::string shmPath(const std::string& name) {
+    return "/dev/shm/" + name;
+}
+
+static std::uint64_t bitsOf(double v) {
+    std::uint64_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    return bits;
+}
+
+static double doubleOf(std::uint64_t bits) {
+    double v;
+    std::memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+static std::uint64_t nowTicks() {
+    return SystemClock().now();
+}
+
+// ---- MarketDataPublisher ----
+
+MarketDataPublisher::MarketDataPublisher(const std::string& name, std::size_t ring_capacity)
+    : device_(0), inode_(0), region_(nullptr), region_size_(0), capacity_(1), next_sequence_(1), top_sequence_(0),
+      top_() {
+    while (capacity_ < ring_capacity) capacity_ <<= 1;
+#ifdef __linux__
+    if (name.empty() || name.find('/') != std::string::npos) return;
+    std::string path = shmPath(name);
+    // Never resize a region in place: a reader with it mapped would fault on the lost pages
+    unlink(path.c_str());
+    int fd = open(path.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        std::cerr << "[MarketDataPublisher] Cannot create " << path << std::endl;
+        return;
+    }
+    std::size_t size = regionSize(capacity_);
+    struct stat st;
+    void* p = fstat(fd, &st) == 0 && ftruncate(fd, static_cast<off_t>(size)) == 0
+        ? mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)
+        : MAP_FAILED;
+    close(fd);
+    if (p == MAP_FAILED) {
+        std::cerr << "[MarketDataPublisher] Cannot map " << path << std::endl;
+        unlink(path.c_str());
+        return;
+    }
+    region_ = static_cast<char*>(p);
+    region_size_ = size;
+    path_ = path;
+    device_ = static_cast<std::uint64_t>(st.st_dev);
+    inode_ = static_cast<std::uint64_t>(st.st_ino);
+    // The file starts zeroed; construct the atomics in place over it
+    RegionHeader* header = new (region_) RegionHeader();
+    SeqlockTop* top = new (region_ + kTopOffset) SeqlockTop();
+    RingCursor* cursor = new (region_ + kCursorOffset) RingCursor();
+    top->sequence.store(0, std::memory_order_relaxed);
+    cursor->write_sequence.store(0, std::memory_order_relaxed);
+    RingSlot* slots = reinterpret_cast<RingSlot*>(region_ + kSlotsOffset);
+    for (std::size_t i = 0; i < capacity_; ++i) {
+        new (&slots[i]) RingSlot();
+        slots[i].sequence.store(0, std::memory_order_relaxed);
+    }
+    header->capacity = capacity_;
+    header->record_words = kRecordWords;
+    header->magic.store(kRegionMagic, std::memory_order_release);
+#else
+    (void)name;
+#endif
+}
+
+MarketDataPublisher::~MarketDataPublisher() {
+#ifdef __linux__
+    if (region_) {
+        munmap(region_, region_size_);
+        // Readers that still have it mapped keep their view. A newer publisher may have
+        // replaced the name already; leave its region alone.
+        struct stat st;
+        if (stat(path_.c_str(), &st) == 0 && static_cast<std::uint64_t>(st.st_dev) == device_ &&
+            static_cast<std::uint64_t>(st.st_ino) == inode_) {
+            unlink(path_.c_str());
+        }
+    }
+#endif
+}
+
+void MarketDataPublisher::onFill(const Fill& fill) {
+    BroadcastRecord record = {0, fill.timestamp, fill.price, fill.quantity, BroadcastKind::TRADE, fill.aggressor,
+                              fill.buy_order_id, fill.sell_order_id};
+    publish(record);
+}
+
+void MarketDataPublisher::onLevelChange(const LevelUpdate& update) {
+    BroadcastRecord record = {0, nowTicks(), update.price, update.quantity, BroadcastKind::LEVEL, update.side, 0, 0};
+    publish(record);
+}
+
+void MarketDataPublisher::onBookState(const BookState& state) {
+    if (!region_) return;
+    if (state.best_bid == top_.bid_price && state.best_bid_quantity == top_.bid_quantity &&
+        state.best_ask == top_.ask_price && state.best_ask_quantity == top_.ask_quantity) {
+        return;
+    }
+    top_ = TopOfBookSnapshot{++top_sequence_, nowTicks(), state.best_bid, state.best_bid_quantity,
+                             state.best_ask, state.best_ask_quantity};
+    SeqlockTop* top = reinterpret_cast<SeqlockTop*>(region_ + kTopOffset);
+    std::uint64_t seq = top->sequence.load(std::memory_order_relaxed);
+    top->sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    top->words[0].store(top_.sequence, std::memory_order_relaxed);
+    top->words[1].store(top_.timestamp, std::memory_order_relaxed);
+    top->words[2].store(bitsOf(top_.bid_price), std::memory_order_relaxed);
+    top->words[3].store(static_cast<std::uint64_t>(top_.bid_quantity), std::memory_order_relaxed);
+    top->words[4].store(bitsOf(top_.ask_price), std::memory_order_relaxed);
+    top->words[5].store(static_cast<std::uint64_t>(top_.ask_quantity), std::memory_order_relaxed);
+    top->sequence.store(seq + 2, std::memory_order_release);
+}
+
+void MarketDataPublisher::publish(const BroadcastRecord& record) {
+    if (!region_) return;
+    std::uint64_t n = next_sequence_++;
+    RingSlot& slot = reinterpret_cast<RingSlot*>(region_ + kSlotsOffset)[n & (capacity_ - 1)];
+    // A reader still copying the record this slot held sees the 0 and drops its copy
+    slot.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.words[0].store(record.timestamp, std::memory_order_relaxed);
+    slot.words[1].store(bitsOf(record.price), std::memory_order_relaxed);
+    slot.words[2].store(static_cast<std::uint64_t>(record.quantity), std::memory_order_relaxed);
+    slot.words[3].store(static_cast<std::uint64_t>(record.kind) |
+                        (static_cast<std::uint64_t>(record.side == Order::Side::SELL) << 8), std::memory_order_relaxed);
+    slot.words[4].store(static_cast<std::uint32_t>(record.buy_order_id) |
+                        (static_cast<std::uint64_t>(static_cast<std::uint32_t>(record.sell_order_id)) << 32),
+                        std::memory_order_relaxed);
+    slot.sequence.store(n, std::memory_order_release);
+    reinterpret_cast<RingCursor*>(region_ + kCursorOffset)->write_sequence.store(n, std::memory_order_release);
+}
+
+// ---- MarketDataReader ----
+
+MarketDataReader::MarketDataReader(const std::string& name)
+    : region_(nullptr), region_size_(0), capacity_(0), next_(1), lost_(0) {
+#ifdef __linux__
+    if (name.empty() || name.find('/') != std::string::npos) return;
+    int fd = open(shmPath(name).c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return;
+    struct stat st;
+    void* p = MAP_FAILED;
+    std::size_t size = 0;
+    if (fstat(fd, &st) == 0 && static_cast<std::size_t>(st.st_size) >= kSlotsOffset) {
+        size = static_cast<std::size_t>(st.st_size);
+        p = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    }
+    close(fd);
+    if (p == MAP_FAILED) return;
+    const RegionHeader* header = static_cast<const RegionHeader*>(p);
+    if (header->magic.load(std::memory_order_acquire) != kRegionMagic || header->record_words != kRecordWords ||
+        header->capacity == 0 || (header->capacity & (header->capacity - 1)) != 0 ||
+        regionSize(header->capacity) != size) {
+        munmap(p, size);
+        return;
+    }
+    region_ = static_cast<const char*>(p);
+    region_size_ = size;
+    capacity_ = header->capacity;
+    // Start from the oldest record still in the ring
+    std::uint64_t head = reinterpret_cast<const RingCursor*>(region_ + kCursorOffset)->write_sequence.load(std::memory_order_acquire);
+    next_ = head >= capacity_ ? head - capacity_ + 1 : 1;
+#else
+    (void)name;
+#endif
+}
+
+MarketDataReader::~MarketDataReader() {
+#ifdef __linux__
+    if (region_) munmap(const_cast<char*>(region_), region_size_);
+#endif
+}
+
+bool MarketDataReader::topOfBook(TopOfBookSnapshot& snapshot) const {
+    if (!region_) return false;
+    const SeqlockTop* top = reinterpret_cast<const SeqlockTop*>(region_ + kTopOffset);
+    std::uint64_t words[kTopWords];
+    bool stable = false;
+    std::uint64_t pending = 0; // odd sequence of the update we are waiting on
+    std::chrono::steady_clock::time_point pending_since;
+    while (!stable) {
+        std::uint64_t before = top->sequence.load(std::memory_order_acquire);
+        if (before & 1) {
+            // Only an update that never finishes counts against the limit; a busy writer does not
+            std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+            if (before != pending) {
+                pending = before;
+                pending_since = now;
+            } else if (now - pending_since > kTopStallLimit) {
+                return false;
+            }
+            continue;
+        }
+        for (std::size_t i = 0; i < kTopWords; ++i) {
+            words[i] = top->words[i].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        stable = top->sequence.load(std::memory_order_relaxed) == before;
+    }
+    snapshot.sequence = words[0];
+    snapshot.timestamp = words[1];
+    snapshot.bid_price = doubleOf(words[2]);
+    snapshot.bid_quantity = static_cast<std::int64_t>(words[3]);
+    snapshot.ask_price = doubleOf(words[4]);
+    snapshot.ask_quantity = static_cast<std::int64_t>(words[5]);
+    return true;
+}
+
+bool MarketDataReader::poll(BroadcastRecord& record) {
+    if (!region_) return false;
+    const RingCursor* cursor = reinterpret_cast<const RingCursor*>(region_ + kCursorOffset);
+    const RingSlot* slots = reinterpret_cast<const RingSlot*>(region_ + kSlotsOffset);
+    std::uint64_t head = cursor->write_sequence.load(std::memory_order_acquire);
+    if (next_ > head) return false;
+    // Lapped: everything before the oldest record in the ring has been overwritten
+    std::uint64_t oldest = head >= capacity_ ? head - capacity_ + 1 : 1;
+    if (next_ < oldest) {
+        lost_ += oldest - next_;
+        next_ = oldest;
+    }
+    // A slot not holding next_ (before or after the copy) is being rewritten for a later
+    // record, i.e. the writer is lapping us right now. Report nothing; the next poll sees
+    // the new head and counts the loss.
+    const RingSlot& slot = slots[next_ & (capacity_ - 1)];
+    if (slot.sequence.load(std::memory_order_acquire) != next_) return false;
+    std::uint64_t words[kRecordWords];
+    for (std::size_t i = 0; i < kRecordWords; ++i) {
+        words[i] = slot.words[i].load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.sequence.load(std::memory_order_relaxed) != next_) return false;
+    record.sequence = next_++;
+    record.timestamp = words[0];
+    record.price = doubleOf(words[1]);
+    record.quantity = static_cast<std::int64_t>(words[2]);
+    record.kind = static_cast<BroadcastKind>(words[3] & 0xff);
+    record.side = ((words[3] >> 8) & 1) ? Order::Side::SELL : Order::Side::BUY;
+    record.buy_order_id = static_cast<int>(static_cast<std::uint32_t>(words[4]));
+    record.sell_order_id = static_cast<int>(static_cast<std::uint32_t>(words[4] >> 32));
+    return true;
+}
+
+void MarketDataReader::seekToLatest() {
+    if (!region_) return;
+    next_ = reinterpret_cast<const RingCursor*>(region_ + kCursorOffset)->write_sequence.load(std::memory_order_acquire) + 1;
+}
@@ -1,99 +1,281 @@
 #include "StrategyEngine.h"
+#include "CpuAffinity.h"
+#include "Telemetry.h"
 #include <iostream>
 #include <random>
-// #include <thread> // Threading disabled for compatibility
+#include <thread>
 #include <algorithm>
+#include <cmath>
 #include <numeric>
 
 StrategyEngine::StrategyEngine(OrderBook& order_book, double spread, int interval_ms)
-    : order_book_(order_book), spread_(spread), interval_ms_(interval_ms), running_(false), next_order_id_(10000) {}
+    : order_book_(order_book), spread_(spread), interval_ms_(interval_ms), running_(false), next_order_id_(10000),
+      latency_(nullptr), top_(), top_changed_(false), dispatching_(false) {}
 
 StrategyEngine::~StrategyEngine() {
     stop();
+    if (!strategies_.empty()) order_book_.removeEventListener(this);
+}
+
+void StrategyEngine::addStrategy(std::unique_ptr<Strategy> strategy) {
+    Strategy* added = strategy.get();
+    strategies_.push_back(std::move(strategy));
+    added->setOwnerID(static_cast<int>(strategies_.size()));
+    added->setOrderSender(this);
+    // Subscribe only once there is someone to deliver to
+    if (strategies_.size() == 1) order_book_.addEventListener(this);
+    BookState state = order_book_.bookState();
+    top_ = TopOfBook{state.best_bid, state.best_bid_quantity, state.best_ask, state.best_ask_quantity};
+    // Start from the current book rather than waiting for its next change
+    added->onTopOfBookChange(top_);
+}
+
+void StrategyEngine::setRuntimeConfig(const RuntimeConfig& config) {
+    config_ = config;
+}
+
+void StrategyEngine::setLatencySimulator(LatencySimulator<OrderBook>* simulator) {
+    latency_ = simulator;
 }
 
-// Threading disabled: start is a no-op
 void StrategyEngine::start() {
-    // No background thread
-    std::cout << "[StrategyEngine] Threading is disabled. No orders will be submitted automatically.\n";
+    if (!config_.engine_thread) {
+        // No background thread; the caller drives run()
+        std::cout << "[StrategyEngine] Threading is disabled. No orders will be submitted automatically.\n";
+        return;
+    }
+    if (running_.exchange(true)) return;
+    thread_ = std::thread(&StrategyEngine::loop, this);
 }
 
-// Threading disabled: stop is a no-op
 void StrategyEngine::stop() {
-    // No background thread
+    running_ = false;
+    if (thread_.joinable()) thread_.join();
 }
 
-// Threading disabled: always returns false
 bool StrategyEngine::isRunning() const {
-    return false;
+    return running_;
 }
 
-// Main loop for submitting orders (not used)
 void StrategyEngine::run() {
-    // Threading is disabled; this function is not used.
-} 
+    for (std::size_t i = 0; i < strategies_.size(); ++i) {
+        strategies_[i]->step();
+    }
+    telemetryAdd(Metric::STRATEGY_STEPS, static_cast<std::int64_t>(strategies_.size()));
+    order_book_.matchOrders();
+    order_book_.checkStopOrders();
+    if (latency_) latency_->advanceTo(latency_->now() + static_cast<std::uint64_t>(interval_ms_) * 1000000);
+}
+
+void StrategyEngine::sendOrder(int owner_id, const Order& order) {
+    if (latency_) {
+        latency_->submitOrder(owner_id, order);
+    } else {
+        order_book_.addOrder(order);
+    }
+}
+
+void StrategyEngine::sendCancel(int owner_id, int order_id) {
+    if (latency_) {
+        latency_->submitCancel(owner_id, order_id);
+    } else {
+        order_book_.cancelOrder(order_id);
+    }
+}
+
+std::int64_t StrategyEngine::queuePosition(int order_id) const {
+    return order_book_.queuePosition(order_id);
+}
+
+void StrategyEngine::onFill(const Fill& fill) {
+    // Mid-match: the book is not safe to re-enter yet, so just queue the fill
+    pending_fills_.push_back(fill);
+}
+
+void StrategyEngine::onBookState(const BookState& state) {
+    if (state.best_bid != top_.bid_price || state.best_bid_quantity != top_.bid_quantity ||
+        state.best_ask != top_.ask_price || state.best_ask_quantity != top_.ask_quantity) {
+        top_ = TopOfBook{state.best_bid, state.best_bid_quantity, state.best_ask, state.best_ask_quantity};
+        top_changed_ = true;
+    }
+    dispatch();
+}
+
+void StrategyEngine::dispatch() {
+    // Nested book calls from a callback land here too; the outermost dispatch delivers their events
+    if (dispatching_) return;
+    dispatching_ = true;
+    std::size_t next = 0;
+    for (;;) {
+        if (next < pending_fills_.size()) {
+            // Copy: callbacks may append to pending_fills_
+            Fill fill = pending_fills_[next++];
+            deliver(fill);
+        } else if (top_changed_) {
+            top_changed_ = false;
+            deliverTop(top_);
+        } else {
+            break;
+        }
+    }
+    pending_fills_.clear();
+    dispatching_ = false;
+}
+
+// One strategy's view of a fill: the trade, then its own side(s) of it
+static void notifyFill(Strategy* strategy, const TradeEvent& trade, const Fill& fill) {
+    strategy->onTrade(trade);
+    if (strategy->getOwnerID() == fill.buy_owner_id) {
+        strategy->onOwnFill(OwnFill{fill.buy_order_id, Order::Side::BUY, fill.price, fill.quantity, fill.timestamp});
+    }
+    if (strategy->getOwnerID() == fill.sell_owner_id) {
+        strategy->onOwnFill(OwnFill{fill.sell_order_id, Order::Side::SELL, fill.price, fill.quantity, fill.timestamp});
+    }
+}
+
+void StrategyEngine::deliver(const Fill& fill) {
+    TradeEvent trade = {fill.price, fill.quantity, fill.aggressor, fill.timestamp};
+    if (latency_) {
+        // Each strategy hears about it after its own market-data delay
+        for (std::size_t i = 0; i < strategies_.size(); ++i) {
+            Strategy* strategy = strategies_[i].get();
+            latency_->publishMarketData(strategy->getOwnerID(), [strategy, trade, fill]() { notifyFill(strategy, trade, fill); });
+        }
+        return;
+    }
+    for (std::size_t i = 0; i < strategies_.size(); ++i) {
+        strategies_[i]->onTrade(trade);
+    }
+    if (Strategy* buyer = strategyForOwner(fill.buy_owner_id)) {
+        buyer->onOwnFill(OwnFill{fill.buy_order_id, Order::Side::BUY, fill.price, fill.quantity, fill.timestamp});
+    }
+    if (Strategy* seller = strategyForOwner(fill.sell_owner_id)) {
+        seller->onOwnFill(OwnFill{fill.sell_order_id, Order::Side::SELL, fill.price, fill.quantity, fill.timestamp});
+    }
+}
+
+void StrategyEngine::deliverTop(const TopOfBook& top) {
+    for (std::size_t i = 0; i < strategies_.size(); ++i) {
+        Strategy* strategy = strategies_[i].get();
+        if (latency_) {
+            latency_->publishMarketData(strategy->getOwnerID(), [strategy, top]() { strategy->onTopOfBookChange(top); });
+        } else {
+            strategy->onTopOfBookChange(top);
+        }
+    }
+}
+
+Strategy* StrategyEngine::strategyForOwner(int owner_id) const {
+    // Owner IDs are 1-based positions in strategies_; 0 means an order from outside the engine
+    if (owner_id <= 0 || owner_id > static_cast<int>(strategies_.size())) return nullptr;
+    return strategies_[owner_id - 1].get();
+}
+
+void StrategyEngine::loop() {
+    if (config_.matching_cpu >= 0 && !pinCurrentThread(config_.matching_cpu)) {
+        std::cerr << "[StrategyEngine] Could not pin engine thread to CPU " << config_.matching_cpu << std::endl;
+    }
+    // Pinned first, so the arena lands on (and is pre-faulted from) the engine's own node.
+    // The book owns it and alone allocates from it, so its nodes stay valid for as long as
+    // the book does.
+    if (config_.arena_bytes > 0 && !order_book_.arena()) {
+        int node = config_.numa_node >= 0 ? config_.numa_node : numaNodeOfCpu(config_.matching_cpu);
+        order_book_.attachArena(std::unique_ptr<HugePageArena>(
+            new HugePageArena(config_.arena_bytes, node, config_.huge_pages, config_.prefault)));
+    }
+    const std::chrono::milliseconds interval(interval_ms_);
+    std::chrono::steady_clock::time_point next_tick = std::chrono::steady_clock::now();
+    while (running_.load(std::memory_order_relaxed)) {
+        run();
+        next_tick += interval;
+        if (config_.busy_poll) {
+            // Spin to the next tick: no scheduler wake-up latency, at the cost of a full core
+            while (running_.load(std::memory_order_relaxed) && std::chrono::steady_clock::now() < next_tick) {
+                cpuRelax();
+            }
+        } else {
+            std::this_thread::sleep_until(next_tick);
+        }
+    }
+}
+
+Order Strategy::makeOrder(int id, Order::Side side, double price, int qty) const {
+    std::uint64_t ts = static_cast<std::uint64_t>(std::chrono::system_clock::now().time_since_epoch().count());
+    Order order(id, side, price, qty, ts, Order::OrderType::LIMIT);
+    order.setOwnerID(owner_id_);
+    return order;
+}
+
+void Strategy::sendOrder(const Order& order) {
+    if (sender_) sender_->sendOrder(owner_id_, order);
+}
+
+void Strategy::sendCancel(int order_id) {
+    if (sender_) sender_->sendCancel(owner_id_, order_id);
+}
+
+std::int64_t Strategy::queuePosition(int order_id) const {
+    return sender_ ? sender_->queuePosition(order_id) : -1;
+}
 
 // Market Making: quote both bid and ask around mid-price
-void MarketMakingStrategy::step() {
-    // Estimate mid-price from best buy/sell
-    double best_buy = 0.0, best_sell = 0.0;
-    if (!order_book_.getBuyOrders().empty())
-        best_buy = order_book_.getBuyOrders().front().getPrice();
-    if (!order_book_.getSellOrders().empty())
-        best_sell = order_book_.getSellOrders().front().getPrice();
-    double mid = (best_buy > 0.0 && best_sell > 0.0) ? (best_buy + best_sell) / 2.0 : 100.0;
+void MarketMakingStrategy::onTopOfBookChange(const TopOfBook& top) {
+    double mid = (top.bid_price > 0.0 && top.ask_price > 0.0) ? (top.bid_price + top.ask_price) / 2.0 : 100.0;
     double bid = mid - spread_ / 2.0;
     double ask = mid + spread_ / 2.0;
-    std::uint64_t ts = static_cast<std::uint64_t>(std::chrono::system_clock::now().time_since_epoch().count());
-    order_book_.addOrder(Order(order_id_++, Order::Side::BUY, bid, qty_, ts, Order::OrderType::LIMIT));
-    order_book_.addOrder(Order(order_id_++, Order::Side::SELL, ask, qty_, ts, Order::OrderType::LIMIT));
-}
-
-// Momentum: go with short-term price trend
-void MomentumStrategy::step() {
-    // Use last trade price as signal (or best price if no trades)
-    double price = 0.0;
-    if (!order_book_.getSellOrders().empty())
-        price = order_book_.getSellOrders().front().getPrice();
-    else if (!order_book_.getBuyOrders().empty())
-        price = order_book_.getBuyOrders().front().getPrice();
-    else
-        price = 100.0;
+    requote(bid_id_, bid_price_, bid_open_, Order::Side::BUY, bid);
+    requote(ask_id_, ask_price_, ask_open_, Order::Side::SELL, ask);
+}
+
+void MarketMakingStrategy::onOwnFill(const OwnFill& fill) {
+    if (fill.order_id == bid_id_) bid_open_ -= fill.quantity;
+    if (fill.order_id == ask_id_) ask_open_ -= fill.quantity;
+}
+
+void MarketMakingStrategy::requote(int& quote_id, double& quote_price, int& open, Order::Side side, double target) {
+    if (quote_id >= 0 && open > 0) {
+        // queuePosition is -1 while the quote is still in flight
+        std::int64_t ahead = queuePosition(quote_id);
+        bool at_target = quote_price == target;
+        bool worth_keeping = std::abs(quote_price - target) < spread_ / 2.0 && ahead >= 0 && ahead < qty_;
+        if (at_target || worth_keeping) return;
+        sendCancel(quote_id);
+    }
+    quote_id = order_id_++;
+    quote_price = target;
+    open = qty_;
+    sendOrder(makeOrder(quote_id, side, target, qty_));
+}
+
+// Momentum: go with short-term trade price trend
+void MomentumStrategy::onTrade(const TradeEvent& trade) {
+    double price = trade.price;
     if (last_price_ == 0.0) {
         last_price_ = price;
         return;
     }
-    std::uint64_t ts = static_cast<std::uint64_t>(std::chrono::system_clock::now().time_since_epoch().count());
     if (price > last_price_) {
         // Uptrend: go long
-        order_book_.addOrder(Order(order_id_++, Order::Side::BUY, price + 0.01, qty_, ts, Order::OrderType::LIMIT));
+        sendOrder(makeOrder(order_id_++, Order::Side::BUY, price + 0.01, qty_));
     } else if (price < last_price_) {
         // Downtrend: go short
-        order_book_.addOrder(Order(order_id_++, Order::Side::SELL, price - 0.01, qty_, ts, Order::OrderType::LIMIT));
+        sendOrder(makeOrder(order_id_++, Order::Side::SELL, price - 0.01, qty_));
     }
     last_price_ = price;
 }
 
 // Mean Reversion: bet on return to moving average
-void MeanReversionStrategy::step() {
-    // Use best price as current price
-    double price = 0.0;
-    if (!order_book_.getSellOrders().empty())
-        price = order_book_.getSellOrders().front().getPrice();
-    else if (!order_book_.getBuyOrders().empty())
-        price = order_book_.getBuyOrders().front().getPrice();
-    else
-        price = 100.0;
+void MeanReversionStrategy::onTrade(const TradeEvent& trade) {
+    double price = trade.price;
     price_history_.push_back(price);
     if ((int)price_history_.size() < window_) return;
     if ((int)price_history_.size() > window_) price_history_.erase(price_history_.begin());
     double mean = std::accumulate(price_history_.begin(), price_history_.end(), 0.0) / window_;
-    std::uint64_t ts = static_cast<std::uint64_t>(std::chrono::system_clock::now().time_since_epoch().count());
     if (price < mean - 0.05) {
         // Price below mean: buy
-        order_book_.addOrder(Order(order_id_++, Order::Side::BUY, price + 0.01, qty_, ts, Order::OrderType::LIMIT));
+        sendOrder(makeOrder(order_id_++, Order::Side::BUY, price + 0.01, qty_));
     } else if (price > mean + 0.05) {
         // Price above mean: sell
-        order_book_.addOrder(Order(order_id_++, Order::Side::SELL, price - 0.01, qty_, ts, Order::OrderType::LIMIT));
+        sendOrder(makeOrder(order_id_++, Order::Side::SELL, price - 0.01, qty_));
     }
-} 
\ No newline at end of file
+}
@@ -0,0 +1,214 @@
+#include "Telemetry.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+static const char* const kMetricNames[kMetricCount] = {
+    "orders_added_total",
+    "orders_cancelled_total",
+    "fills_total",
+    "filled_quantity_total",
+    "trades_logged_total",
+    "strategy_steps_total",
+    "buy_levels",
+    "sell_levels",
+    "resting_orders",
+    "pending_stops",
+    "buy_price_heap_size",
+    "sell_price_heap_size",
+    "logger_trades_held",
+};
+
+const char* metricName(Metric metric) {
+    return kMetricNames[static_cast<std::size_t>(metric)];
+}
+
+bool metricIsGauge(Metric metric) {
+    return metric >= Metric::BUY_LEVELS;
+}
+
+// Registry of every slab ever handed out
+static std::mutex& registryMutex() {
+    static std::mutex mutex;
+    return mutex;
+}
+
+static std::vector<TelemetrySlab*>& registrySlabs() {
+    static std::vector<TelemetrySlab*> slabs;
+    return slabs;
+}
+
+static std::uint64_t steadyNowNs() {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+std::atomic<std::int64_t>* telemetryGauges() {
+    alignas(64) static std::atomic<std::int64_t> gauges[kMetricCount - kCounterCount] = {};
+    return gauges;
+}
+
+TelemetrySlab* registerTelemetrySlab() {
+    TelemetrySlab* slab = new TelemetrySlab;
+    for (std::size_t i = 0; i < kCounterCount; ++i) {
+        slab->values[i].store(0, std::memory_order_relaxed);
+    }
+    std::lock_guard<std::mutex> lock(registryMutex());
+    registrySlabs().push_back(slab);
+    return slab;
+}
+
+TelemetrySnapshot snapshotTelemetry() {
+    TelemetrySnapshot snapshot;
+    std::lock_guard<std::mutex> lock(registryMutex());
+    const std::vector<TelemetrySlab*>& slabs = registrySlabs();
+    for (std::size_t s = 0; s < slabs.size(); ++s) {
+        for (std::size_t i = 0; i < kCounterCount; ++i) {
+            snapshot.values[i] += slabs[s]->values[i].load(std::memory_order_relaxed);
+        }
+    }
+    std::atomic<std::int64_t>* gauges = telemetryGauges();
+    for (std::size_t i = kCounterCount; i < kMetricCount; ++i) {
+        snapshot.values[i] = gauges[i - kCounterCount].load(std::memory_order_relaxed);
+    }
+    snapshot.taken_at_ns = steadyNowNs();
+    return snapshot;
+}
+
+std::string formatTelemetry(const TelemetrySnapshot& current, const TelemetrySnapshot* previous) {
+    std::ostringstream out;
+    double seconds = 0.0;
+    if (previous && current.taken_at_ns > previous->taken_at_ns) {
+        seconds = (current.taken_at_ns - previous->taken_at_ns) / 1e9;
+    }
+    for (std::size_t i = 0; i < kMetricCount; ++i) {
+        Metric metric = static_cast<Metric>(i);
+        out << metricName(metric) << ' ' << current.values[i] << '\n';
+        if (seconds > 0.0 && !metricIsGauge(metric)) {
+            std::string name = metricName(metric);
+            name.erase(name.size() - 6); // drop "_total"
+            out << name << "_per_sec " << (current.values[i] - previous->values[i]) / seconds << '\n';
+        }
+    }
+    return out.str();
+}
+
+TelemetryExporter::TelemetryExporter() : running_(false), listen_fd_(-1) {}
+
+TelemetryExporter::~TelemetryExporter() {
+    stop();
+}
+
+bool TelemetryExporter::startSocket(const std::string& path) {
+#ifdef __linux__
+    if (running_) return false;
+    sockaddr_un addr = {};
+    if (path.size() >= sizeof(addr.sun_path)) return false;
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return false;
+    addr.sun_family = AF_UNIX;
+    path.copy(addr.sun_path, path.size());
+    unlink(path.c_str());
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(fd, 16) != 0) {
+        std::cerr << "[Telemetry] Failed to listen on " << path << std::endl;
+        close(fd);
+        return false;
+    }
+    listen_fd_ = fd;
+    path_ = path;
+    running_ = true;
+    thread_ = std::thread(&TelemetryExporter::serveSocket, this);
+    return true;
+#else
+    (void)path;
+    return false;
+#endif
+}
+
+bool TelemetryExporter::startFileDump(const std::string& path, int interval_ms) {
+    if (running_) return false;
+    path_ = path;
+    running_ = true;
+    thread_ = std::thread(&TelemetryExporter::dumpFile, this, interval_ms > 0 ? interval_ms : 1000);
+    return true;
+}
+
+void TelemetryExporter::stop() {
+    if (!running_.exchange(false)) return;
+    if (thread_.joinable()) thread_.join();
+#ifdef __linux__
+    if (listen_fd_ >= 0) {
+        close(listen_fd_);
+        unlink(path_.c_str());
+        listen_fd_ = -1;
+    }
+#endif
+}
+
+bool TelemetryExporter::isRunning() const {
+    return running_;
+}
+
+void TelemetryExporter::serveSocket() {
+#ifdef __linux__
+    TelemetrySnapshot previous = snapshotTelemetry();
+    while (running_) {
+        pollfd pfd = {listen_fd_, POLLIN, 0};
+        if (poll(&pfd, 1, 100) <= 0) continue;
+        int client = accept(listen_fd_, nullptr, nullptr);
+        if (client < 0) continue;
+        // Give an HTTP client a moment to send its request line
+        char request[512];
+        ssize_t n = 0;
+        pollfd cfd = {client, POLLIN, 0};
+        if (poll(&cfd, 1, 50) > 0) n = recv(client, request, sizeof(request), 0);
+        bool http = n >= 4 && std::string(request, 4) == "GET ";
+        TelemetrySnapshot current = snapshotTelemetry();
+        std::string body = formatTelemetry(current, &previous);
+        previous = current;
+        std::string response = http
+            ? "HTTP/1.0 200 OK\r\nContent-Type: text/plain\r\nContent-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body
+            : body;
+        std::size_t sent = 0;
+        while (sent < response.size()) {
+            ssize_t w = send(client, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+            if (w <= 0) break;
+            sent += static_cast<std::size_t>(w);
+        }
+        close(client);
+    }
+#endif
+}
+
+void TelemetryExporter::dumpFile(int interval_ms) {
+    TelemetrySnapshot previous = snapshotTelemetry();
+    std::chrono::steady_clock::time_point next = std::chrono::steady_clock::now();
+    while (running_) {
+        next += std::chrono::milliseconds(interval_ms);
+        // Sleep in short steps so stop() is not held up by a long interval
+        while (running_ && std::chrono::steady_clock::now() < next) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(std::min(interval_ms, 50)));
+        }
+        TelemetrySnapshot current = snapshotTelemetry();
+        // Write then rename, so readers never see a partial file
+        std::string tmp = path_ + ".tmp";
+        {
+            std::ofstream file(tmp);
+            file << formatTelemetry(current, &previous);
+        }
+        std::rename(tmp.c_str(), path_.c_str());
+        previous = current;
+    }
+}
@@ -0,0 +1,509 @@
+#include "TradeAnalytics.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <thread>
+#include <unordered_map>
+
+// Below this many rows per thread a pass is not worth splitting
+static const std::size_t kMinRowsPerThread = 65536;
+// Upper bound on report intervals; wider intervals are used past it
+static const std::uint64_t kMaxIntervals = 1 << 22;
+// Owner IDs below this are counted in a flat table, larger ones (gateway sessions) hashed
+static const int kDirectOwners = 1024;
+
+// Per-owner totals while a pass runs; money in exact ticks so chunks combine in any order
+struct OwnerTotals {
+    int owner_id;
+    std::uint64_t fills;
+    std::int64_t bought;
+    std::int64_t sold;
+    Money notional;
+    Money slippage;
+};
+
+static unsigned threadCount(unsigned requested, std::size_t work, std::size_t min_per_thread) {
+    std::size_t n = requested ? requested : std::thread::hardware_concurrency();
+    n = std::min(n, std::max<std::size_t>(1, work / min_per_thread));
+    return static_cast<unsigned>(std::max<std::size_t>(1, n));
+}
+
+// Calls body(chunk, begin, end) for `threads` contiguous chunks of [0, n), one per thread
+template <class Body>
+static void parallelChunks(std::size_t n, unsigned threads, const Body& body) {
+    std::vector<std::thread> workers;
+    for (unsigned c = 1; c < threads; ++c) {
+        workers.emplace_back(body, c, n * c / threads, n * (c + 1) / threads);
+    }
+    body(0u, std::size_t(0), n / threads);
+    for (std::size_t i = 0; i < workers.size(); ++i) workers[i].join();
+}
+
+void TradeColumns::resize(std::size_t n) {
+    timestamp.resize(n);
+    price_ticks.resize(n);
+    quantity.resize(n);
+    buy_order_id.resize(n);
+    sell_order_id.resize(n);
+    buy_aggressor.resize(n);
+    buy_owner_id.resize(n);
+    sell_owner_id.resize(n);
+}
+
+void TradeColumns::append(const FillRecord& fill) {
+    timestamp.push_back(fill.timestamp);
+    price_ticks.push_back(Money::fromPrice(fill.price).ticks());
+    quantity.push_back(fill.quantity);
+    buy_order_id.push_back(fill.buy_order_id);
+    sell_order_id.push_back(fill.sell_order_id);
+    buy_aggressor.push_back(fill.buy_aggressor ? 1 : 0);
+    buy_owner_id.push_back(fill.buy_owner_id);
+    sell_owner_id.push_back(fill.sell_owner_id);
+}
+
+// Inverse of formatTimestamp(): "HH:MM:SS-dd/mm/YYYY" back to the ticks it was given
+static bool parseLoggerTimestamp(const char* text, std::uint64_t& ticks) {
+    int hour, minute, second, day, month;
+    long long year;
+    if (std::sscanf(text, "%d:%d:%d-%d/%d/%lld", &hour, &minute, &second, &day, &month, &year) != 6) return false;
+    // Days since 1970-01-01 in the proleptic Gregorian calendar
+    long long y = year - (month <= 2 ? 1 : 0);
+    long long era = (y >= 0 ? y : y - 399) / 400;
+    long long yoe = y - era * 400;
+    long long doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    long long days = era * 146097 + yoe * 365 + yoe / 4 - yoe / 100 + doy - 719468;
+    long long seconds = days * 86400 + hour * 3600 + minute * 60 + second;
+    if (seconds < 0) return false;
+    // formatTimestamp() reads its ticks as milliseconds
+    ticks = static_cast<std::uint64_t>(seconds) * 1000;
+    return true;
+}
+
+bool loadTradesCSV(const std::string& filename, TradeColumns& trades) {
+    std::ifstream file(filename);
+    if (!file.is_open()) return false;
+    std::string line;
+    // Skip header
+    if (!std::getline(file, line)) return false;
+    std::uint64_t last_timestamp = 0;
+    while (std::getline(file, line)) {
+        // A blank line starts the trading summary
+        if (line.empty() || line == "\r") break;
+        // buy_order_id,sell_order_id,price,quantity,timestamp,aggressor_side,...
+        const char* p = line.c_str();
+        char* end;
+        FillRecord fill = {};
+        fill.buy_order_id = static_cast<int>(std::strtol(p, &end, 10));
+        if (*end != ',') continue;
+        fill.sell_order_id = static_cast<int>(std::strtol(end + 1, &end, 10));
+        if (*end != ',') continue;
+        fill.price = std::strtod(end + 1, &end);
+        if (*end != ',') continue;
+        fill.quantity = static_cast<int>(std::strtol(end + 1, &end, 10));
+        if (*end != ',') continue;
+        const char* ts = end + 1;
+        const char* comma = std::strchr(ts, ',');
+        if (!comma) continue;
+        if (parseLoggerTimestamp(ts, fill.timestamp)) {
+            last_timestamp = fill.timestamp;
+        } else {
+            fill.timestamp = last_timestamp;
+        }
+        fill.buy_aggressor = std::strncmp(comma + 1, "BUY", 3) == 0;
+        trades.append(fill);
+    }
+    return true;
+}
+
+bool loadTradesColumnar(const std::string& filename, TradeColumns& trades, unsigned threads) {
+    ColumnarTradeReader reader(filename);
+    if (!reader.isOpen()) return false;
+    std::size_t chunks = reader.chunkCount();
+    std::vector<std::size_t> first_row(chunks + 1, 0);
+    for (std::size_t c = 0; c < chunks; ++c) first_row[c + 1] = first_row[c] + reader.chunk(c).rows;
+    std::size_t base = trades.size();
+    trades.resize(base + first_row[chunks]);
+
+    // Each thread decodes whole chunks through its own file handle into its rows
+    unsigned n = threadCount(threads, chunks, 1);
+    std::vector<char> ok(n, 1);
+    std::int64_t scale = reader.priceScale();
+    parallelChunks(chunks, n, [&](unsigned t, std::size_t begin, std::size_t end) {
+        ColumnarTradeReader local(filename);
+        if (!local.isOpen()) {
+            ok[t] = 0;
+            return;
+        }
+        for (std::size_t c = begin; c < end; ++c) {
+            std::size_t row = base + first_row[c];
+            std::size_t rows = first_row[c + 1] - first_row[c];
+            std::vector<std::int64_t> columns[kTradeColumnCount];
+            for (std::size_t k = 0; k < kTradeColumnCount; ++k) {
+                columns[k] = local.readColumn(c, static_cast<TradeColumn>(k));
+                // A corrupt block decodes to nothing rather than to a short column
+                if (columns[k].size() != rows) {
+                    ok[t] = 0;
+                    return;
+                }
+            }
+            auto column = [&](TradeColumn which) -> const std::vector<std::int64_t>& {
+                return columns[static_cast<std::size_t>(which)];
+            };
+            for (std::size_t i = 0; i < rows; ++i) {
+                trades.timestamp[row + i] = static_cast<std::uint64_t>(column(TradeColumn::TIMESTAMP)[i]);
+            }
+            const std::vector<std::int64_t>& price = column(TradeColumn::PRICE);
+            if (scale == kMoneyScale) {
+                std::copy(price.begin(), price.end(), trades.price_ticks.begin() + static_cast<std::ptrdiff_t>(row));
+            } else {
+                for (std::size_t i = 0; i < rows; ++i) {
+                    trades.price_ticks[row + i] = Money::fromPrice(static_cast<double>(price[i]) / scale).ticks();
+                }
+            }
+            const std::vector<std::int64_t>& quantity = column(TradeColumn::QUANTITY);
+            std::copy(quantity.begin(), quantity.end(), trades.quantity.begin() + static_cast<std::ptrdiff_t>(row));
+            for (std::size_t i = 0; i < rows; ++i) {
+                trades.buy_order_id[row + i] = static_cast<int>(column(TradeColumn::BUY_ORDER_ID)[i]);
+                trades.sell_order_id[row + i] = static_cast<int>(column(TradeColumn::SELL_ORDER_ID)[i]);
+                trades.buy_aggressor[row + i] = column(TradeColumn::AGGRESSOR)[i] != 0 ? 1 : 0;
+                trades.buy_owner_id[row + i] = static_cast<int>(column(TradeColumn::BUY_OWNER_ID)[i]);
+                trades.sell_owner_id[row + i] = static_cast<int>(column(TradeColumn::SELL_OWNER_ID)[i]);
+            }
+        }
+    });
+    if (std::find(ok.begin(), ok.end(), 0) != ok.end()) {
+        trades.resize(base);
+        return false;
+    }
+    return true;
+}
+
+bool loadTrades(const std::string& filename, TradeColumns& trades, unsigned threads) {
+    std::ifstream file(filename, std::ios::binary);
+    if (!file.is_open()) return false;
+    char magic[4] = {};
+    file.read(magic, sizeof(magic));
+    if (file.gcount() == 4 && std::memcmp(magic, "HFTC", 4) == 0) {
+        return loadTradesColumnar(filename, trades, threads);
+    }
+    return loadTradesCSV(filename, trades);
+}
+
+// Interval of a timestamp; rows mostly arrive in time order, so the division is only
+// needed when a row leaves the interval of the one before
+struct IntervalCursor {
+    std::uint64_t t_min;
+    std::uint64_t interval;
+    std::uint64_t start = 1;
+    std::uint64_t end = 0;
+    std::size_t bucket = 0;
+
+    IntervalCursor(std::uint64_t first, std::uint64_t width) : t_min(first), interval(width) {}
+
+    std::size_t operator()(std::uint64_t ts) {
+        if (ts < start || ts >= end) {
+            bucket = static_cast<std::size_t>((ts - t_min) / interval);
+            start = t_min + bucket * interval;
+            end = start + interval;
+        }
+        return bucket;
+    }
+};
+
+// Signed quantity the account traded in fill i: + bought, - sold, 0 not involved
+static inline std::int64_t accountQuantity(const TradeColumns& t, std::size_t i, int account) {
+    if (account == kAggressorAccount) {
+        return t.quantity[i] * (2 * static_cast<std::int64_t>(t.buy_aggressor[i]) - 1);
+    }
+    return t.quantity[i] * ((t.buy_owner_id[i] == account ? 1 : 0) - (t.sell_owner_id[i] == account ? 1 : 0));
+}
+
+AnalyticsReport analyzeTrades(const TradeColumns& t, const AnalyticsOptions& options) {
+    AnalyticsReport report;
+    std::size_t n = t.size();
+    if (n == 0) return report;
+    unsigned threads = threadCount(options.threads, n, kMinRowsPerThread);
+    const std::uint64_t* ts = t.timestamp.data();
+    const std::int64_t* price = t.price_ticks.data();
+    const std::int64_t* qty = t.quantity.data();
+
+    // Pass 1: timestamp range and totals per chunk
+    struct ChunkRange {
+        std::uint64_t lo;
+        std::uint64_t hi;
+        std::int64_t volume;
+        Money notional;
+    };
+    std::vector<ChunkRange> ranges(threads);
+    parallelChunks(n, threads, [&](unsigned c, std::size_t begin, std::size_t end) {
+        std::uint64_t lo = std::numeric_limits<std::uint64_t>::max();
+        std::uint64_t hi = 0;
+        std::int64_t volume = 0;
+        Money notional;
+        for (std::size_t i = begin; i < end; ++i) {
+            lo = std::min(lo, ts[i]);
+            hi = std::max(hi, ts[i]);
+            volume += qty[i];
+            notional += Money::fromTicks(price[i]) * qty[i];
+        }
+        ranges[c] = ChunkRange{lo, hi, volume, notional};
+    });
+    std::uint64_t t_min = std::numeric_limits<std::uint64_t>::max();
+    std::uint64_t t_max = 0;
+    Money notional;
+    for (unsigned c = 0; c < threads; ++c) {
+        t_min = std::min(t_min, ranges[c].lo);
+        t_max = std::max(t_max, ranges[c].hi);
+        report.volume += ranges[c].volume;
+        notional += ranges[c].notional;
+    }
+    report.notional = notional.toDouble();
+    bool overflowed = notional.overflowed();
+    report.fills = n;
+    std::uint64_t interval = std::max<std::uint64_t>(1, options.interval);
+    if ((t_max - t_min) / interval + 1 > kMaxIntervals) interval = (t_max - t_min) / (kMaxIntervals - 1) + 1;
+    report.interval = interval;
+    std::size_t interval_count = static_cast<std::size_t>((t_max - t_min) / interval + 1);
+
+    // Pass 2: per-interval volume and the account's net flow per chunk. Each chunk fills its
+    // own interval range, so nothing is shared between threads.
+    struct ChunkFlow {
+        std::size_t first;
+        std::vector<std::int64_t> volume;
+        std::vector<std::uint64_t> trades;
+        std::vector<Money> notional;
+        std::int64_t position;
+        Money cash;
+    };
+    std::vector<ChunkFlow> flows(threads);
+    const int account = options.account;
+    parallelChunks(n, threads, [&](unsigned c, std::size_t begin, std::size_t end) {
+        ChunkFlow& flow = flows[c];
+        flow.first = 0;
+        flow.position = 0;
+        flow.cash = Money();
+        if (begin == end) return;
+        flow.first = static_cast<std::size_t>((ranges[c].lo - t_min) / interval);
+        std::size_t width = static_cast<std::size_t>((ranges[c].hi - t_min) / interval) - flow.first + 1;
+        flow.volume.assign(width, 0);
+        flow.trades.assign(width, 0);
+        flow.notional.assign(width, Money());
+        IntervalCursor cursor(t_min, interval);
+        std::int64_t position = 0;
+        Money cash;
+        for (std::size_t i = begin; i < end; ++i) {
+            std::size_t k = cursor(ts[i]) - flow.first;
+            Money fill_price = Money::fromTicks(price[i]);
+            flow.volume[k] += qty[i];
+            flow.trades[k] += 1;
+            flow.notional[k] += fill_price * qty[i];
+            std::int64_t signed_qty = accountQuantity(t, i, account);
+            position += signed_qty;
+            cash -= fill_price * signed_qty;
+        }
+        flow.position = position;
+        flow.cash = cash;
+    });
+
+    report.intervals.resize(interval_count);
+    for (std::size_t k = 0; k < interval_count; ++k) {
+        report.intervals[k] = IntervalStats{t_min + k * interval, 0, 0, 0.0, 0.0, 0};
+    }
+    std::vector<Money> interval_notional(interval_count);
+    for (unsigned c = 0; c < threads; ++c) {
+        const ChunkFlow& flow = flows[c];
+        for (std::size_t k = 0; k < flow.volume.size(); ++k) {
+            report.intervals[flow.first + k].volume += flow.volume[k];
+            report.intervals[flow.first + k].trades += flow.trades[k];
+            interval_notional[flow.first + k] += flow.notional[k];
+        }
+    }
+    // Slippage is measured against the VWAP truncated to a whole tick, so it stays exact too
+    std::vector<Money> vwap(interval_count);
+    for (std::size_t k = 0; k < interval_count; ++k) {
+        if (report.intervals[k].volume > 0) {
+            report.intervals[k].vwap = interval_notional[k].toDouble() / static_cast<double>(report.intervals[k].volume);
+            vwap[k] = interval_notional[k].scaled(1, report.intervals[k].volume);
+        }
+    }
+
+    // Pass 3: replay each chunk from the account state its predecessors left, tracking
+    // equity fill by fill, the state at each interval's end and per-owner slippage.
+    // Cash, equity and owner totals are exact, so chunk boundaries do not change any of them.
+    struct ChunkState {
+        std::vector<Money> equity;
+        std::vector<std::int64_t> inventory;
+        std::vector<std::uint8_t> seen;
+        Money peak;
+        Money trough;
+        Money drawdown;
+        std::vector<OwnerTotals> direct_owners;
+        std::unordered_map<int, OwnerTotals> owners;
+    };
+    std::vector<std::int64_t> start_position(threads, 0);
+    std::vector<Money> start_cash(threads);
+    for (unsigned c = 1; c < threads; ++c) {
+        start_position[c] = start_position[c - 1] + flows[c - 1].position;
+        start_cash[c] = start_cash[c - 1] + flows[c - 1].cash;
+    }
+    std::vector<ChunkState> states(threads);
+    parallelChunks(n, threads, [&](unsigned c, std::size_t begin, std::size_t end) {
+        ChunkState& state = states[c];
+        const ChunkFlow& flow = flows[c];
+        state.peak = Money::fromTicks(std::numeric_limits<std::int64_t>::min());
+        state.trough = Money::fromTicks(std::numeric_limits<std::int64_t>::max());
+        state.drawdown = Money();
+        state.equity.assign(flow.volume.size(), Money());
+        state.inventory.assign(flow.volume.size(), 0);
+        state.seen.assign(flow.volume.size(), 0);
+        std::int64_t position = start_position[c];
+        Money cash = start_cash[c];
+        state.direct_owners.resize(kDirectOwners);
+        for (int id = 0; id < kDirectOwners; ++id) state.direct_owners[id] = OwnerTotals{id, 0, 0, 0, Money(), Money()};
+        auto owner = [&](int id) -> OwnerTotals& {
+            if (static_cast<unsigned>(id) < static_cast<unsigned>(kDirectOwners)) return state.direct_owners[id];
+            std::unordered_map<int, OwnerTotals>::iterator it = state.owners.find(id);
+            if (it == state.owners.end()) it = state.owners.emplace(id, OwnerTotals{id, 0, 0, 0, Money(), Money()}).first;
+            return it->second;
+        };
+        IntervalCursor cursor(t_min, interval);
+        for (std::size_t i = begin; i < end; ++i) {
+            std::size_t bucket = cursor(ts[i]);
+            std::size_t k = bucket - flow.first;
+            std::int64_t signed_qty = accountQuantity(t, i, account);
+            position += signed_qty;
+            Money fill_price = Money::fromTicks(price[i]);
+            cash -= fill_price * signed_qty;
+            Money equity = cash + fill_price * position;
+            if (state.peak < equity) state.peak = equity;
+            if (equity < state.trough) state.trough = equity;
+            if (state.drawdown < state.peak - equity) state.drawdown = state.peak - equity;
+            state.equity[k] = equity;
+            state.inventory[k] = position;
+            state.seen[k] = 1;
+
+            Money fill_notional = fill_price * qty[i];
+            Money edge = (fill_price - vwap[bucket]) * qty[i];
+            OwnerTotals& buyer = owner(t.buy_owner_id[i]);
+            buyer.fills += 1;
+            buyer.bought += qty[i];
+            buyer.notional += fill_notional;
+            buyer.slippage += edge;
+            OwnerTotals& seller = owner(t.sell_owner_id[i]);
+            seller.fills += 1;
+            seller.sold += qty[i];
+            seller.notional += fill_notional;
+            seller.slippage -= edge;
+        }
+    });
+
+    // Combine in chunk order: later chunks own the end of any interval they share
+    Money running_peak; // equity is 0 before the first fill
+    Money max_drawdown;
+    std::map<int, OwnerTotals> owners;
+    for (unsigned c = 0; c < threads; ++c) {
+        const ChunkState& state = states[c];
+        const ChunkFlow& flow = flows[c];
+        for (std::size_t k = 0; k < state.seen.size(); ++k) {
+            if (!state.seen[k]) continue;
+            report.intervals[flow.first + k].equity = state.equity[k].toDouble();
+            overflowed = overflowed || state.equity[k].overflowed();
+            report.intervals[flow.first + k].inventory = state.inventory[k];
+        }
+        if (state.seen.empty()) continue;
+        if (max_drawdown < state.drawdown) max_drawdown = state.drawdown;
+        if (max_drawdown < running_peak - state.trough) max_drawdown = running_peak - state.trough;
+        if (running_peak < state.peak) running_peak = state.peak;
+        std::vector<const OwnerTotals*> chunk_owners;
+        for (std::size_t i = 0; i < state.direct_owners.size(); ++i) {
+            if (state.direct_owners[i].fills > 0) chunk_owners.push_back(&state.direct_owners[i]);
+        }
+        for (std::unordered_map<int, OwnerTotals>::const_iterator it = state.owners.begin(); it != state.owners.end(); ++it) {
+            chunk_owners.push_back(&it->second);
+        }
+        for (std::size_t i = 0; i < chunk_owners.size(); ++i) {
+            const OwnerTotals& part = *chunk_owners[i];
+            std::map<int, OwnerTotals>::iterator total = owners.find(part.owner_id);
+            if (total == owners.end()) {
+                owners.emplace(part.owner_id, part);
+                continue;
+            }
+            total->second.fills += part.fills;
+            total->second.bought += part.bought;
+            total->second.sold += part.sold;
+            total->second.notional += part.notional;
+            total->second.slippage += part.slippage;
+        }
+    }
+    for (std::map<int, OwnerTotals>::const_iterator it = owners.begin(); it != owners.end(); ++it) {
+        const OwnerTotals& total = it->second;
+        report.owners.push_back(OwnerStats{total.owner_id, total.fills, total.bought, total.sold, total.notional.toDouble(),
+                                           total.slippage.toDouble()});
+        overflowed = overflowed || total.notional.overflowed() || total.slippage.overflowed();
+    }
+    report.max_drawdown = max_drawdown.toDouble();
+    report.overflowed = overflowed || max_drawdown.overflowed();
+
+    // Intervals without fills keep the previous state; then risk ratios over the changes
+    std::vector<std::uint8_t> filled(interval_count, 0);
+    for (unsigned c = 0; c < threads; ++c) {
+        for (std::size_t k = 0; k < states[c].seen.size(); ++k) filled[flows[c].first + k] |= states[c].seen[k];
+    }
+    double previous = 0.0;
+    std::int64_t previous_inventory = 0;
+    double sum = 0.0;
+    double sum_sq = 0.0;
+    double downside_sq = 0.0;
+    for (std::size_t k = 0; k < interval_count; ++k) {
+        IntervalStats& stats = report.intervals[k];
+        if (!filled[k]) {
+            stats.equity = previous;
+            stats.inventory = previous_inventory;
+        }
+        double change = stats.equity - previous;
+        sum += change;
+        sum_sq += change * change;
+        downside_sq += change < 0.0 ? change * change : 0.0;
+        previous = stats.equity;
+        previous_inventory = stats.inventory;
+    }
+    report.final_equity = previous;
+    report.final_inventory = previous_inventory;
+    if (interval_count > 1) {
+        double count = static_cast<double>(interval_count);
+        double mean = sum / count;
+        double variance = (sum_sq - count * mean * mean) / (count - 1.0);
+        if (variance > 0.0) report.sharpe = mean / std::sqrt(variance);
+        double downside = std::sqrt(downside_sq / count);
+        if (downside > 0.0) report.sortino = mean / downside;
+    }
+    return report;
+}
+
+FillRatio computeFillRatio(const std::vector<Order>& orders, const TradeColumns& trades) {
+    FillRatio result;
+    std::unordered_map<int, std::size_t> index;
+    index.reserve(orders.size());
+    for (std::size_t i = 0; i < orders.size(); ++i) {
+        index[orders[i].getOrderID()] = i;
+        result.submitted += orders[i].getQuantity();
+    }
+    result.orders = orders.size();
+    std::vector<std::int64_t> filled(orders.size(), 0);
+    for (std::size_t i = 0; i < trades.size(); ++i) {
+        std::unordered_map<int, std::size_t>::const_iterator buy = index.find(trades.buy_order_id[i]);
+        if (buy != index.end()) filled[buy->second] += trades.quantity[i];
+        std::unordered_map<int, std::size_t>::const_iterator sell = index.find(trades.sell_order_id[i]);
+        if (sell != index.end()) filled[sell->second] += trades.quantity[i];
+    }
+    for (std::size_t i = 0; i < orders.size(); ++i) {
+        if (filled[i] > 0) ++result.orders_filled;
+        result.filled += std::min<std::int64_t>(filled[i], orders[i].getQuantity());
+    }
+    return result;
+}
@@ -2,9 +2,15 @@
 #include <iostream>
 #include <iomanip>
 #include <ctime>
+#include "Telemetry.h"
 #include "Utils.h"
 
-TradeLogger::TradeLogger(const std::string& filename) : file_(filename) {
+TradeLogger::TradeLogger(const std::string& filename, TradeOutputFormat format) : format_(format) {
+    if (format_ == TradeOutputFormat::COLUMNAR) {
+        columnar_.reset(new ColumnarTradeWriter(filename));
+        return;
+    }
+    file_.open(filename);
     // Write CSV header
     file_ << "buy_order_id,sell_order_id,price,quantity,timestamp,aggressor_side,realized_pnl,net_position,avg_price\n";
 }
@@ -17,8 +23,26 @@ TradeLogger::~TradeLogger() {
 }
 
 void TradeLogger::logTrade(const Trade& trade) {
+    ++trade_count_;
+    bool buy_aggressor = (trade.aggressor_side == "BUY");
+    // Converted to exact money once; everything below is integer arithmetic
+    Money price = Money::fromPrice(trade.price);
+    if (buy_aggressor) {
+        aggressor_pnl_ -= price * trade.quantity;
+    } else {
+        aggressor_pnl_ += price * trade.quantity;
+    }
+    updatePosition(trade.quantity, price, buy_aggressor);
+    telemetryAdd(Metric::TRADES_LOGGED);
+
+    if (columnar_) {
+        FillRecord record = {trade.timestamp_raw, trade.price, trade.quantity, trade.buy_order_id, trade.sell_order_id,
+                             buy_aggressor, trade.buy_owner_id, trade.sell_owner_id};
+        columnar_->append(record);
+        return;
+    }
     trades_.push_back(trade);
-    updatePosition(trade);
+    telemetrySet(Metric::LOGGER_TRADES_HELD, static_cast<std::int64_t>(trades_.size()));
     
     if (file_.is_open()) {
         file_ << trade.buy_order_id << ','
@@ -27,46 +51,37 @@ void TradeLogger::logTrade(const Trade& trade) {
               << trade.quantity << ','
               << trade.timestamp << ','
               << trade.aggressor_side << ','
-              << std::fixed << std::setprecision(2) << position_.realized_pnl << ','
+              << std::fixed << std::setprecision(2) << position_.realized_pnl.toDouble() << ','
               << position_.net_quantity << ','
-              << std::fixed << std::setprecision(2) << position_.average_price << '\n';
+              << std::fixed << std::setprecision(2) << position_.average_price() << '\n';
     }
 }
 
-void TradeLogger::updatePosition(const Trade& trade) {
-    bool is_buy = (trade.aggressor_side == "BUY");
-    position_.update(trade.quantity, trade.price, is_buy);
-    last_mark_price_ = trade.price;
+void TradeLogger::updatePosition(int quantity, Money price, bool is_buy) {
+    position_.update(quantity, price, is_buy);
+    last_mark_price_ = price;
     position_.mark_to_market(last_mark_price_);
 }
 
 void TradeLogger::updateMarkPrice(double price) {
-    last_mark_price_ = price;
-    position_.mark_to_market(price);
+    last_mark_price_ = Money::fromPrice(price);
+    position_.mark_to_market(last_mark_price_);
 }
 
 double TradeLogger::getAggressorBasedPnL() const {
-    double pnl = 0.0;
-    for (const auto& trade : trades_) {
-        if (trade.aggressor_side == "BUY") {
-            pnl -= trade.price * trade.quantity;
-        } else {
-            pnl += trade.price * trade.quantity;
-        }
-    }
-    return pnl;
+    return aggressor_pnl_.toDouble();
 }
 
 double TradeLogger::getRealizedPnL() const {
-    return position_.realized_pnl;
+    return position_.realized_pnl.toDouble();
 }
 
 double TradeLogger::getUnrealizedPnL() const {
-    return position_.unrealized_pnl;
+    return position_.unrealized_pnl.toDouble();
 }
 
 double TradeLogger::getTotalPnL() const {
-    return position_.realized_pnl + position_.unrealized_pnl;
+    return (position_.realized_pnl + position_.unrealized_pnl).toDouble();
 }
 
 int TradeLogger::getNetPosition() const {
@@ -74,28 +89,38 @@ int TradeLogger::getNetPosition() const {
 }
 
 double TradeLogger::getAveragePrice() const {
-    return position_.average_price;
+    return position_.average_price();
+}
+
+bool TradeLogger::pnlOverflowed() const {
+    return aggressor_pnl_.overflowed() || position_.realized_pnl.overflowed() || position_.cost_basis.overflowed();
 }
 
 void TradeLogger::writePnLSummary() {
     file_ << "\nTrading Summary\n";
     file_ << "Aggressor-Based P&L," << std::fixed << std::setprecision(2) << getAggressorBasedPnL() << "\n";
-    file_ << "Realized P&L," << position_.realized_pnl << "\n";
-    file_ << "Unrealized P&L," << position_.unrealized_pnl << "\n";
+    file_ << "Realized P&L," << getRealizedPnL() << "\n";
+    file_ << "Unrealized P&L," << getUnrealizedPnL() << "\n";
     file_ << "Total P&L," << getTotalPnL() << "\n";
     file_ << "Final Position," << position_.net_quantity << "\n";
-    file_ << "Average Price," << position_.average_price << "\n";
-    file_ << "Mark Price," << last_mark_price_ << "\n";
+    file_ << "Average Price," << getAveragePrice() << "\n";
+    file_ << "Mark Price," << last_mark_price_.toDouble() << "\n";
+    if (pnlOverflowed()) {
+        file_ << "Warning,P&L overflowed 64-bit ticks; totals are invalid\n";
+    }
 }
 
 void TradeLogger::printSummary() const {
     std::cout << "\n=== Trade Summary ===\n";
-    std::cout << "Total Trades: " << trades_.size() << "\n";
+    std::cout << "Total Trades: " << trade_count_ << "\n";
     std::cout << "Aggressor-Based P&L: " << std::fixed << std::setprecision(2) << getAggressorBasedPnL() << "\n";
-    std::cout << "Realized P&L: " << position_.realized_pnl << "\n";
-    std::cout << "Unrealized P&L: " << position_.unrealized_pnl << "\n";
+    std::cout << "Realized P&L: " << getRealizedPnL() << "\n";
+    std::cout << "Unrealized P&L: " << getUnrealizedPnL() << "\n";
     std::cout << "Total P&L: " << getTotalPnL() << "\n";
     std::cout << "Final Position: " << position_.net_quantity << "\n";
-    std::cout << "Average Price: " << position_.average_price << "\n";
-    std::cout << "Mark Price: " << last_mark_price_ << "\n";
+    std::cout << "Average Price: " << getAveragePrice() << "\n";
+    std::cout << "Mark Price: " << last_mark_price_.toDouble() << "\n";
+    if (pnlOverflowed()) {
+        std::cout << "Warning: P&L overflowed 64-bit ticks; totals are invalid\n";
+    }
 } 
\ No newline at end of file
@@ -1,37 +1,102 @@
 #include <iostream>
 #include <memory>
+#include <chrono>
+#include <csignal>
+#include <thread>
 #include "Order.h"
 #include "OrderBook.h"
 #include "CSVParser.h"
 #include "TradeLogger.h"
 #include "StrategyEngine.h"
+#include "RuntimeConfig.h"
+#include "Telemetry.h"
+#include "OrderGateway.h"
+#include "SharedMarketData.h"
+#include "LatencySimulator.h"
+
+static OrderGateway* g_gateway = nullptr;
+
+static void stopGateway(int) {
+    if (g_gateway) g_gateway->stop();
+}
 
 int main() {
+    // Optional production settings (thread placement, telemetry); defaults when absent
+    RuntimeConfig runtime = loadRuntimeConfig("../data/runtime.cfg");
+    TelemetryExporter telemetry;
+    if (!runtime.telemetry_socket.empty()) {
+        telemetry.startSocket(runtime.telemetry_socket);
+    } else if (!runtime.telemetry_file.empty()) {
+        telemetry.startFileDump(runtime.telemetry_file, runtime.telemetry_interval_ms);
+    }
+
     OrderBook ob;
-    TradeLogger logger("../data/trades.csv");
+    TradeLogger logger(runtime.columnar_trades ? "../data/trades.col" : "../data/trades.csv",
+                       runtime.columnar_trades ? TradeOutputFormat::COLUMNAR : TradeOutputFormat::CSV);
     ob.setTradeLogger(&logger);
 
+    // Local processes can follow the book through shared memory
+    std::unique_ptr<MarketDataPublisher> market_data;
+    if (!runtime.market_data_shm.empty()) {
+        market_data.reset(new MarketDataPublisher(runtime.market_data_shm));
+        if (market_data->isOpen()) ob.addEventListener(market_data.get());
+    }
+
     // Load initial orders from CSV
     std::string filename = "../data/orders.csv";
     auto orders = parseOrdersFromCSV(filename);
     std::cout << "Loaded " << orders.size() << " orders from CSV." << std::endl;
-    for (const auto& order : orders) {
-        ob.addOrder(order);
+    if (runtime.opening_auction) {
+        // Collect the whole open, then trade every crossing order at one price
+        ob.beginAuction();
+        ob.addOrders(orders);
+        AuctionResult open = ob.uncross();
+        std::cout << "[Auction] Uncrossed " << open.volume << " @ " << open.price
+                  << " (imbalance " << open.imbalance << ")" << std::endl;
+    } else {
+        ob.addOrders(orders);
     }
-    ob.matchOrders();
     ob.checkStopOrders();
 
+    // Strategies reach the book, and hear from it, after simulated network delays
+    std::unique_ptr<LatencySimulator<OrderBook>> latency;
+    if (runtime.simulate_latency) latency.reset(new LatencySimulator<OrderBook>(ob, runtime.latency));
+
     // Create strategy engine with market making parameters
     StrategyEngine engine(ob, 0.5, 100); // 0.5 spread, 100ms interval
-    
-    // Start the engine (no-op in non-threaded mode)
-    engine.start();
-    
+    engine.setRuntimeConfig(runtime);
+    engine.setLatencySimulator(latency.get());
+
+    // With a gateway configured, external clients drive the book until SIGINT/SIGTERM
+    bool serve_gateway = !runtime.gateway_socket.empty() || runtime.gateway_port > 0;
+    if (!serve_gateway) {
+        // Start the engine (no-op in non-threaded mode)
+        engine.start();
+    }
+
     // Run for a while
-    for (int i = 0; i < 50; ++i) {
-        engine.run();
-        ob.matchOrders();
-        ob.checkStopOrders();
+    if (serve_gateway) {
+        OrderGateway gateway(ob);
+        bool listening = false;
+        if (!runtime.gateway_socket.empty()) listening = gateway.listenUnix(runtime.gateway_socket) || listening;
+        if (runtime.gateway_port > 0) listening = gateway.listenTcp(runtime.gateway_port) || listening;
+        if (listening) {
+            g_gateway = &gateway;
+            std::signal(SIGINT, stopGateway);
+            std::signal(SIGTERM, stopGateway);
+            std::cout << "[OrderGateway] Accepting orders; Ctrl-C to stop." << std::endl;
+            gateway.run();
+            g_gateway = nullptr;
+        }
+    } else if (engine.isRunning()) {
+        // The engine thread owns the book until it is stopped
+        std::this_thread::sleep_for(std::chrono::milliseconds(50 * 100));
+    } else {
+        for (int i = 0; i < 50; ++i) {
+            engine.run();
+            ob.matchOrders();
+            ob.checkStopOrders();
+        }
     }
     
     // Stop the engine (no-op in non-threaded mode)
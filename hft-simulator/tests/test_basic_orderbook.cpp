@@ -0,0 +1,230 @@
+#include "BasicOrderBook.h"
+#include <cassert>
+#include <iostream>
+#include <vector>
+
+// Sink that records fills so tests can inspect them
+struct RecordingSink : NullEventSink {
+    std::vector<Fill> fills;
+    void onFill(const Fill& fill) { fills.push_back(fill); }
+};
+
+void test_null_sink_book_matches() {
+    BasicOrderBook<> ob;
+    ob.addOrder(Order(1, Order::Side::BUY, 101.0, 10, 1));
+    ob.addOrder(Order(2, Order::Side::SELL, 100.0, 4, 2));
+    ob.matchOrders();
+    auto buys = ob.getBuyOrders();
+    assert(buys.size() == 1);
+    assert(buys[0].getQuantity() == 6);
+    assert(ob.getSellOrders().empty());
+}
+
+void test_simulated_clock_stamps_fills() {
+    BasicOrderBook<RecordingSink, SimulatedClock> ob;
+    ob.clock().advanceTo(5000);
+    ob.addOrder(Order(1, Order::Side::SELL, 100.0, 10, 1));
+    ob.addOrder(Order(2, Order::Side::BUY, 100.5, 10, 2));
+    ob.matchOrders();
+    const std::vector<Fill>& fills = ob.eventSink().fills;
+    assert(fills.size() == 1);
+    assert(fills[0].timestamp == 5000);
+    assert(fills[0].price == 100.0);
+    assert(fills[0].aggressor == Order::Side::BUY);
+    assert(!fills[0].market_order);
+}
+
+void test_tick_price_merges_levels() {
+    BasicOrderBook<RecordingSink, SimulatedClock, TickPrice<100>> ob;
+    ob.addOrder(Order(1, Order::Side::SELL, 100.10, 5, 1));
+    ob.addOrder(Order(2, Order::Side::SELL, 100.1000000001, 5, 2));
+    Order market(3, Order::Side::BUY, 0.0, 10, 3, Order::OrderType::MARKET);
+    ob.addOrder(market);
+    const std::vector<Fill>& fills = ob.eventSink().fills;
+    assert(fills.size() == 2);
+    assert(fills[0].sell_order_id == 1);
+    assert(fills[1].sell_order_id == 2);
+    assert(fills[0].price == 100.10);
+    assert(fills[1].market_order);
+    assert(ob.getSellOrders().empty());
+}
+
+void test_pool_storage_cancel_and_reuse() {
+    BasicOrderBook<NullEventSink, SimulatedClock, DoublePrice, PoolStorage> ob;
+    for (int round = 0; round < 3; ++round) {
+        for (int i = 0; i < 1000; ++i) {
+            ob.addOrder(Order(i, Order::Side::BUY, 90.0 + (i % 10), 1, i));
+        }
+        for (int i = 0; i < 1000; ++i) {
+            assert(ob.cancelOrder(i));
+        }
+        assert(ob.getBuyOrders().empty());
+    }
+}
+
+void test_reduce_order_rejects_non_positive() {
+    BasicOrderBook<> ob;
+    ob.addOrder(Order(1, Order::Side::BUY, 100.0, 10, 1));
+    assert(!ob.reduceOrder(1, 0));
+    assert(!ob.reduceOrder(1, -5));
+    assert(ob.getBuyOrders()[0].getQuantity() == 10);
+    assert(ob.queuePosition(1) == 0);
+    assert(ob.reduceOrder(1, 4) && ob.getBuyOrders()[0].getQuantity() == 6);
+    assert(ob.reduceOrder(1, 6) && ob.getBuyOrders().empty());
+    assert(!ob.reduceOrder(1, 1));
+}
+
+void test_stale_levels_are_skipped() {
+    BasicOrderBook<RecordingSink> ob;
+    ob.addOrder(Order(1, Order::Side::BUY, 102.0, 5, 1));
+    ob.addOrder(Order(2, Order::Side::BUY, 101.0, 5, 2));
+    assert(ob.cancelOrder(1));
+    ob.addOrder(Order(3, Order::Side::SELL, 100.0, 5, 3));
+    ob.matchOrders();
+    const std::vector<Fill>& fills = ob.eventSink().fills;
+    assert(fills.size() == 1);
+    assert(fills[0].buy_order_id == 2);
+}
+
+void test_stop_order_activation() {
+    BasicOrderBook<RecordingSink> ob;
+    ob.addOrder(Order(1, Order::Side::SELL, 100.0, 5, 1));
+    ob.addOrder(Order(2, Order::Side::BUY, 0.0, 5, 2, 100.5));
+    ob.checkStopOrders();
+    const std::vector<Fill>& fills = ob.eventSink().fills;
+    assert(fills.size() == 1);
+    assert(fills[0].buy_order_id == 2);
+    assert(fills[0].market_order);
+}
+
+// Sink that records every published book state
+struct StateSink : NullEventSink {
+    std::vector<BookState> states;
+    void onBookState(const BookState& state) { states.push_back(state); }
+};
+
+void test_add_orders_publishes_once() {
+    BasicOrderBook<StateSink> ob;
+    std::vector<Order> batch;
+    batch.push_back(Order(1, Order::Side::BUY, 101.0, 10, 1));
+    batch.push_back(Order(2, Order::Side::SELL, 100.0, 10, 2));
+    batch.push_back(Order(3, Order::Side::SELL, 102.0, 5, 3));
+    ob.addOrders(batch);
+    // One state for the batch, taken after matching: never the crossed book
+    const std::vector<BookState>& states = ob.eventSink().states;
+    assert(states.size() == 1);
+    assert(states[0].best_bid == 0.0);
+    assert(states[0].best_ask == 102.0);
+    assert(states[0].resting_orders == 1);
+}
+
+void test_auction_uncross_at_equilibrium() {
+    BasicOrderBook<RecordingSink> ob;
+    ob.beginAuction();
+    ob.addOrder(Order(1, Order::Side::BUY, 102.0, 10, 1));
+    ob.addOrder(Order(2, Order::Side::BUY, 101.0, 20, 2));
+    ob.addOrder(Order(3, Order::Side::BUY, 100.0, 30, 3));
+    ob.addOrder(Order(4, Order::Side::SELL, 99.0, 15, 4));
+    ob.addOrder(Order(5, Order::Side::SELL, 100.0, 15, 5));
+    ob.addOrder(Order(6, Order::Side::SELL, 101.0, 25, 6));
+    ob.addOrder(Order(7, Order::Side::SELL, 103.0, 10, 7));
+    ob.addOrder(Order(8, Order::Side::BUY, 0.0, 5, 8, Order::OrderType::MARKET));
+    ob.matchOrders();
+    ob.checkStopOrders();
+    assert(ob.eventSink().fills.empty());
+    assert(ob.inAuction());
+
+    // The held market buy adds 5 at every price: 101 executes 35 (35 bid vs 55 ask), 100 only 30
+    AuctionResult indicative = ob.indicativeAuction();
+    assert(indicative.price == 101.0 && indicative.volume == 35 && indicative.imbalance == -20);
+    AuctionResult result = ob.uncross();
+    assert(result.price == indicative.price && result.volume == indicative.volume);
+    assert(!ob.inAuction());
+
+    const std::vector<Fill>& fills = ob.eventSink().fills;
+    assert(fills.size() == 4);
+    std::int64_t volume = 0;
+    for (std::size_t i = 0; i < fills.size(); ++i) {
+        assert(fills[i].price == 101.0);
+        volume += fills[i].quantity;
+    }
+    assert(volume == 35);
+    // The held market order trades first, at the uncross price
+    assert(fills[0].buy_order_id == 8 && fills[0].sell_order_id == 4 && fills[0].market_order);
+    assert(fills[1].buy_order_id == 1 && fills[1].sell_order_id == 4 && !fills[1].market_order);
+    assert(fills[2].buy_order_id == 2 && fills[2].sell_order_id == 5);
+    assert(fills[3].buy_order_id == 2 && fills[3].sell_order_id == 6 && fills[3].quantity == 5);
+
+    assert(ob.getBuyOrders().size() == 1 && ob.getBuyOrders()[0].getOrderID() == 3);
+    assert(ob.getSellOrders().size() == 2 && ob.getSellOrders()[0].getQuantity() == 20);
+    assert(ob.indicativeAuction().volume == 0);
+}
+
+void test_auction_tie_follows_surplus() {
+    BasicOrderBook<RecordingSink> ob;
+    ob.beginAuction();
+    ob.addOrder(Order(1, Order::Side::BUY, 101.0, 10, 1));
+    ob.addOrder(Order(2, Order::Side::SELL, 100.0, 5, 2));
+    // 5 executes at 100 or 101 with 5 buy surplus either way; buyers push it up
+    AuctionResult result = ob.uncross();
+    assert(result.price == 101.0 && result.volume == 5 && result.imbalance == 5);
+    assert(ob.eventSink().fills.size() == 1 && ob.eventSink().fills[0].price == 101.0);
+
+    BasicOrderBook<RecordingSink> empty;
+    empty.beginAuction();
+    empty.addOrder(Order(1, Order::Side::BUY, 99.0, 10, 1));
+    AuctionResult none = empty.uncross();
+    assert(none.volume == 0 && none.price == 0.0);
+    assert(!empty.inAuction());
+}
+
+// Sink that records fills and dropped market order remainders
+struct AuctionSink : RecordingSink {
+    std::vector<std::pair<int, int>> dropped;
+    void onRemainderDropped(int order_id, int quantity) { dropped.push_back(std::make_pair(order_id, quantity)); }
+};
+
+void test_auction_market_orders_set_the_price() {
+    BasicOrderBook<AuctionSink> ob;
+    ob.beginAuction();
+    ob.addOrder(Order(1, Order::Side::SELL, 100.0, 10, 1));
+    ob.addOrder(Order(2, Order::Side::SELL, 101.0, 10, 2));
+    ob.addOrder(Order(3, Order::Side::BUY, 0.0, 15, 3, Order::OrderType::MARKET));
+    ob.addOrder(Order(4, Order::Side::BUY, 0.0, 10, 4, Order::OrderType::MARKET));
+    ob.addOrder(Order(5, Order::Side::SELL, 0.0, 2, 5, Order::OrderType::MARKET));
+    // No limit order crosses, but 25 shares of market demand do: 22 execute at 101
+    AuctionResult indicative = ob.indicativeAuction();
+    assert(indicative.price == 101.0 && indicative.volume == 22 && indicative.imbalance == 3);
+    AuctionResult result = ob.uncross();
+    assert(result.price == 101.0 && result.volume == 22);
+
+    const std::vector<Fill>& fills = ob.eventSink().fills;
+    assert(fills.size() == 4);
+    assert(fills[0].buy_order_id == 3 && fills[0].sell_order_id == 5 && fills[0].quantity == 2);
+    assert(fills[1].buy_order_id == 3 && fills[1].sell_order_id == 1 && fills[1].quantity == 10);
+    assert(fills[2].buy_order_id == 3 && fills[2].sell_order_id == 2 && fills[2].quantity == 3);
+    assert(fills[3].buy_order_id == 4 && fills[3].sell_order_id == 2 && fills[3].quantity == 7);
+    for (std::size_t i = 0; i < fills.size(); ++i) {
+        assert(fills[i].price == 101.0 && fills[i].market_order);
+    }
+    // Nothing is carried into continuous trading
+    const std::vector<std::pair<int, int>>& dropped = ob.eventSink().dropped;
+    assert(dropped.size() == 1 && dropped[0].first == 4 && dropped[0].second == 3);
+    assert(ob.getSellOrders().empty() && ob.getBuyOrders().empty());
+}
+
+int main() {
+    test_null_sink_book_matches();
+    test_simulated_clock_stamps_fills();
+    test_tick_price_merges_levels();
+    test_pool_storage_cancel_and_reuse();
+    test_reduce_order_rejects_non_positive();
+    test_stale_levels_are_skipped();
+    test_stop_order_activation();
+    test_add_orders_publishes_once();
+    test_auction_uncross_at_equilibrium();
+    test_auction_tie_follows_surplus();
+    test_auction_market_orders_set_the_price();
+    std::cout << "BasicOrderBook policy tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,226 @@
+#include "ColumnarTradeStore.h"
+#include "OrderBook.h"
+#include "TradeAnalytics.h"
+#include "TradeLogger.h"
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <vector>
+
+static std::vector<FillRecord> makeFills(std::size_t n) {
+    std::mt19937 rng(11);
+    std::vector<FillRecord> fills;
+    std::uint64_t ts = 1700000000000000000ULL;
+    double price = 100.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        ts += rng() % 5000;
+        price += (static_cast<int>(rng() % 5) - 2) * 0.01;
+        FillRecord r = {ts, price, static_cast<int>(1 + rng() % 100), static_cast<int>(i * 2), static_cast<int>(i * 2 + 1),
+                        (rng() & 1) != 0, static_cast<int>(rng() % 4), static_cast<int>(rng() % 4)};
+        fills.push_back(r);
+    }
+    return fills;
+}
+
+static long fileSize(const char* path) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    return static_cast<long>(in.tellg());
+}
+
+void test_round_trip() {
+    const char* path = "test_fills.col";
+    std::vector<FillRecord> fills = makeFills(25000);
+    {
+        ColumnarTradeWriter writer(path, 10000);
+        for (std::size_t i = 0; i < fills.size(); ++i) writer.append(fills[i]);
+        assert(writer.rowsWritten() == fills.size());
+    }
+    ColumnarTradeReader reader(path);
+    assert(reader.isOpen());
+    assert(reader.chunkCount() == 3);
+    assert(reader.rowCount() == fills.size());
+    std::size_t row = 0;
+    for (std::size_t c = 0; c < reader.chunkCount(); ++c) {
+        std::vector<FillRecord> rows = reader.readRows(c);
+        for (std::size_t i = 0; i < rows.size(); ++i, ++row) {
+            const FillRecord& a = fills[row];
+            const FillRecord& b = rows[i];
+            assert(a.timestamp == b.timestamp);
+            assert(std::llround(a.price * 10000) == std::llround(b.price * 10000));
+            assert(a.quantity == b.quantity);
+            assert(a.buy_order_id == b.buy_order_id && a.sell_order_id == b.sell_order_id);
+            assert(a.buy_aggressor == b.buy_aggressor);
+            assert(a.buy_owner_id == b.buy_owner_id && a.sell_owner_id == b.sell_owner_id);
+        }
+    }
+    assert(row == fills.size());
+    // Roughly what the CSV logger writes per row, before the P&L columns
+    assert(fileSize(path) < static_cast<long>(fills.size()) * 12);
+    std::remove(path);
+}
+
+void test_single_column_and_chunk_skipping() {
+    const char* path = "test_fills_skip.col";
+    {
+        ColumnarTradeWriter writer(path, 100);
+        for (int i = 0; i < 1000; ++i) {
+            FillRecord r = {static_cast<std::uint64_t>(i) * 1000, 100.0 + i * 0.01, 1, i, i, true, 1, 2};
+            writer.append(r);
+        }
+    }
+    ColumnarTradeReader reader(path);
+    assert(reader.chunkCount() == 10);
+    const TradeChunkInfo& first = reader.chunk(0);
+    assert(first.column(TradeColumn::TIMESTAMP).min == 0);
+    assert(first.column(TradeColumn::TIMESTAMP).max == 99000);
+    // Only chunks 3 and 4 can hold timestamps in [350000, 420000]
+    std::vector<std::size_t> hits = reader.chunksInRange(TradeColumn::TIMESTAMP, 350000, 420000);
+    assert((hits == std::vector<std::size_t>{3, 4}));
+    std::vector<std::int64_t> prices = reader.readColumn(4, TradeColumn::PRICE);
+    assert(prices.size() == 100);
+    assert(prices.front() == 1040000 && prices.back() == 1049900);
+    assert(reader.ticksToPrice(prices.front()) == 104.0);
+    std::vector<std::int64_t> owners = reader.readColumn(9, TradeColumn::SELL_OWNER_ID);
+    assert(owners.size() == 100 && owners[0] == 2 && owners[99] == 2);
+    std::remove(path);
+}
+
+void test_trade_logger_columnar_mode() {
+    const char* path = "test_logger.col";
+    {
+        TradeLogger logger(path, TradeOutputFormat::COLUMNAR);
+        OrderBook ob;
+        ob.setTradeLogger(&logger);
+        Order buy(1, Order::Side::BUY, 101.0, 10, 1);
+        buy.setOwnerID(5);
+        ob.addOrder(buy);
+        ob.addOrder(Order(2, Order::Side::SELL, 100.5, 4, 2));
+        ob.matchOrders();
+        assert(logger.getNetPosition() == -4);
+        assert(logger.getAggressorBasedPnL() == 100.5 * 4);
+    }
+    ColumnarTradeReader reader(path);
+    assert(reader.rowCount() == 1);
+    std::vector<FillRecord> rows = reader.readRows(0);
+    assert(rows[0].buy_order_id == 1 && rows[0].sell_order_id == 2);
+    assert(rows[0].price == 100.5 && rows[0].quantity == 4);
+    assert(!rows[0].buy_aggressor);
+    assert(rows[0].buy_owner_id == 5 && rows[0].sell_owner_id == 0);
+    assert(rows[0].timestamp > 0);
+    std::remove(path);
+}
+
+void test_reader_rejects_garbage() {
+    const char* path = "test_garbage.col";
+    {
+        std::ofstream out(path);
+        out << "not a column store";
+    }
+    ColumnarTradeReader reader(path);
+    assert(!reader.isOpen());
+    assert(reader.readColumn(0, TradeColumn::PRICE).empty());
+    std::remove(path);
+}
+
+void test_reader_rejects_bad_footer_offset() {
+    // Valid header and trailer magic, but the footer offset points past the end of the file
+    const char* path = "test_bad_footer.col";
+    {
+        std::ofstream out(path, std::ios::binary);
+        const unsigned char header[16] = {'H', 'F', 'T', 'C', 1, 0, 0, 0, 0x10, 0x27, 0, 0, 0, 0, 0, 0};
+        const unsigned char trailer[12] = {0xe8, 0x03, 0, 0, 0, 0, 0, 0, 'H', 'F', 'T', 'C'};
+        out.write(reinterpret_cast<const char*>(header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(trailer), sizeof(trailer));
+    }
+    ColumnarTradeReader reader(path);
+    assert(!reader.isOpen());
+    assert(reader.rowCount() == 0);
+    std::remove(path);
+}
+
+// Overwrite bytes of a file in place
+static void patch(const char* path, std::uint64_t offset, const std::vector<unsigned char>& bytes) {
+    std::fstream f(path, std::ios::binary | std::ios::in | std::ios::out);
+    f.seekp(static_cast<std::streamoff>(offset));
+    f.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+}
+
+static std::vector<unsigned char> le(std::uint64_t v, int bytes) {
+    std::vector<unsigned char> out;
+    for (int i = 0; i < bytes; ++i) out.push_back(static_cast<unsigned char>(v >> (8 * i)));
+    return out;
+}
+
+void test_reader_rejects_corrupt_blocks() {
+    const char* path = "test_corrupt_block.col";
+    std::vector<FillRecord> fills = makeFills(50);
+    auto write = [&]() {
+        ColumnarTradeWriter writer(path);
+        for (std::size_t i = 0; i < fills.size(); ++i) writer.append(fills[i]);
+    };
+    // Footer: chunk count, then per chunk its rows and one entry per column
+    auto footerOffset = [&]() {
+        std::ifstream in(path, std::ios::binary);
+        in.seekg(-12, std::ios::end);
+        unsigned char trailer[8];
+        in.read(reinterpret_cast<char*>(trailer), 8);
+        std::uint64_t offset = 0;
+        for (int i = 0; i < 8; ++i) offset |= static_cast<std::uint64_t>(trailer[i]) << (8 * i);
+        return offset;
+    };
+    auto columnEntry = [&](TradeColumn column) { return footerOffset() + 8 + static_cast<std::size_t>(column) * 28; };
+
+    // An empty aggressor bitmap fails its column and the rows, not reads past it
+    write();
+    patch(path, columnEntry(TradeColumn::AGGRESSOR) + 8, le(0, 4));
+    {
+        ColumnarTradeReader reader(path);
+        assert(reader.isOpen());
+        assert(reader.readColumn(0, TradeColumn::AGGRESSOR).empty());
+        assert(reader.readColumn(0, TradeColumn::PRICE).size() == 50);
+        assert(reader.readRows(0).empty());
+    }
+    TradeColumns trades;
+    assert(!loadTrades(path, trades) && trades.size() == 0);
+
+    // A dictionary length far beyond the block is rejected without allocating it
+    write();
+    std::uint64_t owners;
+    {
+        ColumnarTradeReader reader(path);
+        owners = reader.chunk(0).column(TradeColumn::BUY_OWNER_ID).offset;
+    }
+    patch(path, owners, {0xff, 0xff, 0xff, 0xff, 0x0f});
+    {
+        ColumnarTradeReader reader(path);
+        assert(reader.readColumn(0, TradeColumn::BUY_OWNER_ID).empty());
+        assert(reader.readRows(0).empty());
+    }
+
+    // A row count the blocks cannot hold
+    write();
+    patch(path, footerOffset() + 4, le(0xffffffffu, 4));
+    assert(!ColumnarTradeReader(path).isOpen());
+
+    // Unknown version, then a zero price scale
+    write();
+    patch(path, 4, le(2, 4));
+    assert(!ColumnarTradeReader(path).isOpen());
+    write();
+    patch(path, 8, le(0, 8));
+    assert(!ColumnarTradeReader(path).isOpen());
+    std::remove(path);
+}
+
+int main() {
+    test_round_trip();
+    test_single_column_and_chunk_skipping();
+    test_trade_logger_columnar_mode();
+    test_reader_rejects_garbage();
+    test_reader_rejects_bad_footer_offset();
+    test_reader_rejects_corrupt_blocks();
+    std::cout << "Columnar trade store tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,313 @@
+#include "OrderGateway.h"
+#include <arpa/inet.h>
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <netinet/in.h>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <vector>
+
+// Blocking test client; the gateway is driven with poll() on the same thread.
+
+int connectUnix(const std::string& path) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    path.copy(addr.sun_path, path.size());
+    assert(connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+    return fd;
+}
+
+int connectTcp(int port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(static_cast<std::uint16_t>(port));
+    assert(connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+    return fd;
+}
+
+void sendBytes(int fd, const void* data, std::size_t size) {
+    assert(send(fd, data, size, 0) == static_cast<ssize_t>(size));
+}
+
+GatewayNewOrder newOrder(std::uint32_t id, GatewaySide side, double price, std::uint32_t qty,
+                         GatewayOrderType type = GatewayOrderType::LIMIT) {
+    GatewayNewOrder msg = {};
+    msg.header.length = sizeof(msg);
+    msg.header.type = GatewayMessageType::NEW_ORDER;
+    msg.client_order_id = id;
+    msg.side = side;
+    msg.order_type = type;
+    msg.price = static_cast<std::int64_t>(price * kGatewayPriceScale);
+    msg.quantity = qty;
+    return msg;
+}
+
+GatewayCancel cancelMsg(std::uint32_t id) {
+    GatewayCancel msg = {};
+    msg.header.length = sizeof(msg);
+    msg.header.type = GatewayMessageType::CANCEL;
+    msg.client_order_id = id;
+    return msg;
+}
+
+// Replies decoded from one client's stream
+struct Replies {
+    std::vector<GatewayAck> acks;
+    std::vector<GatewayReject> rejects;
+    std::vector<GatewayFill> fills;
+    std::vector<GatewayMessageType> order;
+};
+
+// Poll the gateway until `count` reply messages have arrived on fd
+Replies collect(OrderGateway& gateway, int fd, std::size_t count) {
+    Replies replies;
+    std::vector<char> buffer;
+    for (int round = 0; round < 200 && replies.order.size() < count; ++round) {
+        gateway.poll(10);
+        char chunk[4096];
+        ssize_t n = recv(fd, chunk, sizeof(chunk), MSG_DONTWAIT);
+        if (n > 0) buffer.insert(buffer.end(), chunk, chunk + n);
+        std::size_t offset = 0;
+        while (buffer.size() - offset >= sizeof(GatewayHeader)) {
+            GatewayHeader header;
+            std::memcpy(&header, buffer.data() + offset, sizeof(header));
+            if (buffer.size() - offset < header.length) break;
+            const char* p = buffer.data() + offset;
+            if (header.type == GatewayMessageType::ACK) {
+                GatewayAck m;
+                std::memcpy(&m, p, sizeof(m));
+                replies.acks.push_back(m);
+            } else if (header.type == GatewayMessageType::REJECT) {
+                GatewayReject m;
+                std::memcpy(&m, p, sizeof(m));
+                replies.rejects.push_back(m);
+            } else {
+                assert(header.type == GatewayMessageType::FILL);
+                GatewayFill m;
+                std::memcpy(&m, p, sizeof(m));
+                replies.fills.push_back(m);
+            }
+            replies.order.push_back(header.type);
+            offset += header.length;
+        }
+        buffer.erase(buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(offset));
+    }
+    assert(replies.order.size() == count);
+    return replies;
+}
+
+std::string socketPath() {
+    return "/tmp/hft_gateway_test_" + std::to_string(getpid()) + ".sock";
+}
+
+void test_new_order_ack_and_fill() {
+    OrderBook ob;
+    OrderGateway gateway(ob);
+    assert(gateway.listenUnix(socketPath()));
+    int seller = connectUnix(socketPath());
+    int buyer = connectUnix(socketPath());
+
+    GatewayNewOrder sell = newOrder(1, GatewaySide::SELL, 100.5, 10);
+    sendBytes(seller, &sell, sizeof(sell));
+    Replies s1 = collect(gateway, seller, 1);
+    assert(s1.acks.size() == 1 && s1.acks[0].client_order_id == 1 && s1.acks[0].status == GatewayAckStatus::ACCEPTED);
+    assert(gateway.sessionCount() == 2);
+
+    // Both clients use client order ID 1; the book sees distinct IDs
+    GatewayNewOrder buy = newOrder(1, GatewaySide::BUY, 101.0, 4);
+    sendBytes(buyer, &buy, sizeof(buy));
+    Replies b = collect(gateway, buyer, 2);
+    assert(b.order[0] == GatewayMessageType::ACK && b.order[1] == GatewayMessageType::FILL);
+    assert(b.acks[0].order_id != s1.acks[0].order_id);
+    assert(b.fills[0].client_order_id == 1 && b.fills[0].side == GatewaySide::BUY);
+    assert(b.fills[0].quantity == 4 && b.fills[0].leaves == 0);
+    assert(b.fills[0].price == 1005000);
+
+    Replies s2 = collect(gateway, seller, 1);
+    assert(s2.fills[0].side == GatewaySide::SELL && s2.fills[0].leaves == 6);
+    assert(ob.getSellOrders().size() == 1 && ob.getSellOrders()[0].getQuantity() == 6);
+    close(seller);
+    close(buyer);
+}
+
+void test_cancel_amend_and_rejects() {
+    OrderBook ob;
+    OrderGateway gateway(ob);
+    assert(gateway.listenTcp(0));
+    assert(gateway.tcpPort() > 0);
+    int fd = connectTcp(gateway.tcpPort());
+
+    // Several messages in one send are decoded in one pass and acked in one batch
+    GatewayNewOrder a = newOrder(7, GatewaySide::BUY, 99.0, 5);
+    GatewayNewOrder dup = newOrder(7, GatewaySide::BUY, 98.0, 5);
+    GatewayNewOrder bad = newOrder(8, GatewaySide::BUY, 98.0, 0);
+    char batch[sizeof(a) * 3];
+    std::memcpy(batch, &a, sizeof(a));
+    std::memcpy(batch + sizeof(a), &dup, sizeof(dup));
+    std::memcpy(batch + 2 * sizeof(a), &bad, sizeof(bad));
+    sendBytes(fd, batch, sizeof(batch));
+    Replies r = collect(gateway, fd, 3);
+    assert(r.acks.size() == 1 && r.acks[0].leaves == 5);
+    assert(r.rejects.size() == 2);
+    assert(r.rejects[0].reason == GatewayRejectReason::DUPLICATE_ID);
+    assert(r.rejects[1].reason == GatewayRejectReason::INVALID_FIELDS);
+
+    GatewayAmend amend = {};
+    amend.header.length = sizeof(amend);
+    amend.header.type = GatewayMessageType::AMEND;
+    amend.client_order_id = 7;
+    amend.price = 995000;
+    amend.quantity = 3;
+    sendBytes(fd, &amend, sizeof(amend));
+    Replies am = collect(gateway, fd, 1);
+    assert(am.acks[0].status == GatewayAckStatus::AMENDED && am.acks[0].order_id != r.acks[0].order_id);
+    assert(am.acks[0].leaves == 3);
+    assert(ob.getBuyOrders().size() == 1 && ob.getBuyOrders()[0].getPrice() == 99.5);
+    assert(ob.getBuyOrders()[0].getQuantity() == 3);
+
+    // A message split across sends is held until complete
+    GatewayCancel cancel = cancelMsg(7);
+    sendBytes(fd, &cancel, 3);
+    gateway.poll(10);
+    assert(ob.getBuyOrders().size() == 1);
+    sendBytes(fd, reinterpret_cast<const char*>(&cancel) + 3, sizeof(cancel) - 3);
+    Replies c = collect(gateway, fd, 1);
+    assert(c.acks[0].status == GatewayAckStatus::CANCELLED && c.acks[0].leaves == 3);
+    assert(ob.getBuyOrders().empty());
+
+    sendBytes(fd, &cancel, sizeof(cancel));
+    Replies again = collect(gateway, fd, 1);
+    assert(again.rejects[0].reason == GatewayRejectReason::UNKNOWN_ORDER);
+    close(fd);
+}
+
+void test_disconnect_cancels_and_bad_frames_close() {
+    OrderBook ob;
+    OrderGateway gateway(ob);
+    assert(gateway.listenUnix(socketPath()));
+    int fd = connectUnix(socketPath());
+    GatewayNewOrder a = newOrder(1, GatewaySide::SELL, 101.0, 5);
+    sendBytes(fd, &a, sizeof(a));
+    collect(gateway, fd, 1);
+    assert(ob.getSellOrders().size() == 1);
+    close(fd);
+    for (int i = 0; i < 50 && gateway.sessionCount() > 0; ++i) gateway.poll(10);
+    assert(gateway.sessionCount() == 0);
+    assert(ob.getSellOrders().empty());
+
+    // A header with the wrong length for its type drops the session
+    int rogue = connectUnix(socketPath());
+    GatewayNewOrder b = newOrder(2, GatewaySide::SELL, 101.0, 5);
+    b.header.length = 12;
+    sendBytes(rogue, &b, sizeof(b));
+    for (int i = 0; i < 50 && gateway.sessionCount() == 0; ++i) gateway.poll(10);
+    for (int i = 0; i < 50 && gateway.sessionCount() > 0; ++i) gateway.poll(10);
+    assert(gateway.sessionCount() == 0);
+    assert(ob.getSellOrders().empty());
+    close(rogue);
+}
+
+void test_market_order_and_stop() {
+    OrderBook ob;
+    OrderGateway gateway(ob);
+    assert(gateway.listenUnix(socketPath()));
+    ob.addOrder(Order(1, Order::Side::SELL, 100.0, 3, 1));
+    int fd = connectUnix(socketPath());
+    GatewayNewOrder m = newOrder(5, GatewaySide::BUY, 0.0, 5, GatewayOrderType::MARKET);
+    sendBytes(fd, &m, sizeof(m));
+    Replies r = collect(gateway, fd, 3);
+    assert(r.order[0] == GatewayMessageType::ACK && r.order[1] == GatewayMessageType::FILL);
+    assert(r.fills[0].quantity == 3 && r.fills[0].leaves == 2);
+    // The unfilled remainder was dropped and the client is told so; the ID is free again
+    assert(r.acks.size() == 2 && r.acks[1].status == GatewayAckStatus::EXPIRED && r.acks[1].leaves == 2);
+    GatewayCancel cancel = cancelMsg(5);
+    sendBytes(fd, &cancel, sizeof(cancel));
+    Replies c = collect(gateway, fd, 1);
+    assert(c.rejects.size() == 1);
+
+    // A stop needs a trigger price
+    GatewayNewOrder stop = newOrder(6, GatewaySide::BUY, 100.0, 1, GatewayOrderType::STOP);
+    sendBytes(fd, &stop, sizeof(stop));
+    Replies s = collect(gateway, fd, 1);
+    assert(s.rejects.size() == 1 && s.rejects[0].reason == GatewayRejectReason::INVALID_FIELDS);
+    close(fd);
+}
+
+void test_stops_and_held_market_orders() {
+    OrderBook ob;
+    OrderGateway gateway(ob);
+    assert(gateway.listenUnix(socketPath()));
+    int fd = connectUnix(socketPath());
+
+    // A pending stop is cancelled by its client order ID; its limit price is not needed
+    GatewayNewOrder stop = newOrder(1, GatewaySide::BUY, 0.0, 5, GatewayOrderType::STOP);
+    stop.stop_price = 99 * kGatewayPriceScale;
+    sendBytes(fd, &stop, sizeof(stop));
+    collect(gateway, fd, 1);
+    GatewayCancel cancel = cancelMsg(1);
+    sendBytes(fd, &cancel, sizeof(cancel));
+    Replies c = collect(gateway, fd, 1);
+    assert(c.acks.size() == 1 && c.acks[0].status == GatewayAckStatus::CANCELLED && c.acks[0].leaves == 5);
+    assert(ob.bookState().pending_stops == 0);
+    assert(gateway.liveOrderCount() == 0);
+
+    // An activated stop that runs out of liquidity expires with its remainder
+    stop.client_order_id = 2;
+    sendBytes(fd, &stop, sizeof(stop));
+    collect(gateway, fd, 1);
+    int seller = connectUnix(socketPath());
+    GatewayNewOrder sell = newOrder(1, GatewaySide::SELL, 98.0, 2, GatewayOrderType::LIMIT);
+    sendBytes(seller, &sell, sizeof(sell));
+    Replies s = collect(gateway, fd, 2);
+    assert(s.fills.size() == 1 && s.fills[0].quantity == 2 && s.fills[0].leaves == 3);
+    assert(s.acks.size() == 1 && s.acks[0].status == GatewayAckStatus::EXPIRED && s.acks[0].leaves == 3);
+    assert(gateway.liveOrderCount() == 0);
+
+    // Market orders held by an auction are reported when it uncrosses, or can be cancelled
+    ob.beginAuction();
+    ob.addOrder(Order(2, Order::Side::SELL, 100.0, 4, 2));
+    GatewayNewOrder market = newOrder(3, GatewaySide::BUY, 0.0, 3, GatewayOrderType::MARKET);
+    sendBytes(fd, &market, sizeof(market));
+    market.client_order_id = 4;
+    sendBytes(fd, &market, sizeof(market));
+    collect(gateway, fd, 2);
+    assert(gateway.liveOrderCount() == 2);
+    cancel = cancelMsg(4);
+    sendBytes(fd, &cancel, sizeof(cancel));
+    c = collect(gateway, fd, 1);
+    assert(c.acks.size() == 1 && c.acks[0].status == GatewayAckStatus::CANCELLED);
+    ob.uncross();
+    // Replies to book calls made outside the loop go out with the next round
+    cancel = cancelMsg(99);
+    sendBytes(fd, &cancel, sizeof(cancel));
+    Replies u = collect(gateway, fd, 2);
+    assert(u.fills.size() == 1 && u.fills[0].client_order_id == 3 && u.fills[0].quantity == 3 && u.fills[0].leaves == 0);
+    assert(gateway.liveOrderCount() == 0);
+    assert(ob.getSellOrders().size() == 1 && ob.getSellOrders()[0].getQuantity() == 1);
+    close(seller);
+    close(fd);
+}
+
+void test_run_and_stop() {
+    OrderBook ob;
+    OrderGateway gateway(ob);
+    gateway.stop(); // a stop before run() ends the first round
+    gateway.run();
+}
+
+int main() {
+    test_new_order_ack_and_fill();
+    test_cancel_amend_and_rejects();
+    test_disconnect_cancels_and_bad_frames_close();
+    test_market_order_and_stop();
+    test_stops_and_held_market_orders();
+    test_run_and_stop();
+    std::cout << "Order gateway tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,234 @@
+#include "ItchReplay.h"
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+
+// Builds ITCH 5.0 style messages (2-byte length prefix, big-endian fields)
+class ItchWriter {
+public:
+    std::string bytes;
+
+    void stockDirectory(std::uint16_t locate, const std::string& symbol) {
+        begin('R', locate, 39);
+        putSymbol(symbol);
+        bytes.append(20, '\0'); // market category .. inverse indicator
+    }
+    void addOrder(std::uint16_t locate, std::uint64_t ts, std::uint64_t ref, char side, std::uint32_t shares,
+                  const std::string& symbol, std::uint32_t price, bool with_mpid = false) {
+        begin(with_mpid ? 'F' : 'A', locate, with_mpid ? 40 : 36, ts);
+        put(ref, 8);
+        bytes.push_back(side);
+        put(shares, 4);
+        putSymbol(symbol);
+        put(price, 4);
+        if (with_mpid) bytes.append("MPID");
+    }
+    void executed(std::uint16_t locate, std::uint64_t ref, std::uint32_t shares) {
+        begin('E', locate, 31);
+        put(ref, 8);
+        put(shares, 4);
+        put(1, 8); // match number
+    }
+    void executedWithPrice(std::uint16_t locate, std::uint64_t ref, std::uint32_t shares, std::uint32_t price) {
+        begin('C', locate, 36);
+        put(ref, 8);
+        put(shares, 4);
+        put(2, 8);
+        bytes.push_back('Y');
+        put(price, 4);
+    }
+    void cancel(std::uint16_t locate, std::uint64_t ref, std::uint32_t shares) {
+        begin('X', locate, 23);
+        put(ref, 8);
+        put(shares, 4);
+    }
+    void remove(std::uint16_t locate, std::uint64_t ref) {
+        begin('D', locate, 19);
+        put(ref, 8);
+    }
+    void replace(std::uint16_t locate, std::uint64_t old_ref, std::uint64_t new_ref, std::uint32_t shares, std::uint32_t price) {
+        begin('U', locate, 35);
+        put(old_ref, 8);
+        put(new_ref, 8);
+        put(shares, 4);
+        put(price, 4);
+    }
+    void systemEvent() {
+        begin('S', 0, 12);
+        bytes.push_back('O');
+    }
+
+private:
+    void put(std::uint64_t v, int n) {
+        for (int i = n - 1; i >= 0; --i) bytes.push_back(static_cast<char>((v >> (8 * i)) & 0xff));
+    }
+    void putSymbol(const std::string& symbol) {
+        std::string padded = symbol;
+        padded.resize(8, ' ');
+        bytes.append(padded);
+    }
+    void begin(char type, std::uint16_t locate, std::uint16_t length, std::uint64_t ts = 0) {
+        put(length, 2);
+        bytes.push_back(type);
+        put(locate, 2);
+        put(0, 2); // tracking number
+        put(ts, 6);
+    }
+};
+
+using LeanBook = BasicOrderBook<NullEventSink, SimulatedClock, TickPrice<10000>, PoolStorage>;
+
+ItchWriter sampleDay() {
+    ItchWriter w;
+    w.systemEvent();
+    w.stockDirectory(1, "AAPL");
+    w.stockDirectory(2, "MSFT");
+    w.addOrder(1, 1000, 11, 'B', 100, "AAPL", 1500000);
+    w.addOrder(1, 1001, 12, 'B', 50, "AAPL", 1500000, true);
+    w.addOrder(1, 1002, 13, 'S', 200, "AAPL", 1501000);
+    w.addOrder(2, 1003, 21, 'S', 300, "MSFT", 3200000);
+    w.executed(1, 11, 40);           // 11: 100 -> 60, keeps its place
+    w.executedWithPrice(1, 13, 200, 1501000); // 13 fully executed
+    w.cancel(2, 21, 100);            // 21: 300 -> 200
+    w.replace(1, 12, 14, 70, 1499000);
+    w.remove(2, 21);
+    w.addOrder(2, 1004, 22, 'B', 10, "MSFT", 3190000);
+    return w;
+}
+
+void test_replay_rebuilds_books() {
+    ItchWriter w = sampleDay();
+    ItchReplay<> replay;
+    replay.replay(w.bytes.data(), w.bytes.size());
+    const ItchStats& s = replay.stats();
+    assert(s.messages == 13);
+    assert(s.adds == 5 && s.executions == 2 && s.executed_shares == 240);
+    assert(s.cancels == 1 && s.deletes == 1 && s.replaces == 1);
+    assert(s.ignored == 1 && s.malformed == 0 && !s.truncated);
+    assert(replay.symbols().size() == 2);
+
+    OrderBook* aapl = replay.book("AAPL");
+    assert(aapl);
+    std::vector<Order> bids = aapl->getBuyOrders();
+    assert(bids.size() == 2);
+    assert(bids[0].getPrice() == 150.0 && bids[0].getQuantity() == 60);
+    assert(bids[1].getPrice() == 149.9 && bids[1].getQuantity() == 70);
+    assert(aapl->getSellOrders().empty());
+
+    OrderBook* msft = replay.book("MSFT");
+    assert(msft->getSellOrders().empty());
+    assert(msft->getBuyOrders().size() == 1 && msft->getBuyOrders()[0].getPrice() == 319.0);
+    assert(!replay.book("GOOG"));
+}
+
+void test_symbol_filter_and_file() {
+    ItchWriter w = sampleDay();
+    std::string path = "/tmp/hft_itch_test_" + std::to_string(getpid()) + ".bin";
+    {
+        std::ofstream out(path, std::ios::binary);
+        out.write(w.bytes.data(), static_cast<std::streamsize>(w.bytes.size()));
+    }
+    ItchReplay<LeanBook> replay;
+    replay.setSymbolFilter({"MSFT"});
+    assert(replay.replayFile(path));
+    std::remove(path.c_str());
+    assert(replay.symbols().size() == 1 && replay.book("MSFT") && !replay.book("AAPL"));
+    const ItchStats& s = replay.stats();
+    assert(s.adds == 2 && s.cancels == 1 && s.deletes == 1);
+    // AAPL adds and everything that refers to them are skipped
+    assert(s.ignored == 1 + 3 + 3);
+    assert(replay.book("MSFT")->getBuyOrders()[0].getQuantity() == 10);
+    assert(!replay.replayFile(path));
+}
+
+void test_queue_priority_survives_partial_execution() {
+    ItchWriter w;
+    w.addOrder(7, 1, 1, 'S', 100, "XYZ", 100000);
+    w.addOrder(7, 2, 2, 'S', 100, "XYZ", 100000);
+    w.executed(7, 1, 30);
+    w.cancel(7, 2, 10);
+    ItchReplay<LeanBook> replay;
+    replay.replay(w.bytes.data(), w.bytes.size());
+    LeanBook* book = replay.book("XYZ");
+    // Without a directory message the symbol comes from the add itself
+    assert(book);
+    std::vector<Order> asks = book->getSellOrders();
+    assert(asks.size() == 2 && asks[0].getQuantity() == 70 && asks[1].getQuantity() == 90);
+    assert(book->queuePosition(asks[1].getOrderID()) == 70);
+}
+
+void test_truncated_and_malformed() {
+    ItchWriter w;
+    w.addOrder(1, 1, 1, 'B', 5, "AAA", 10000);
+    std::string bytes = w.bytes;
+    // An 'E' whose length is too short for its layout
+    bytes += std::string("\x00\x05" "E\x00\x01\x00\x00", 7);
+    ItchReplay<LeanBook> replay;
+    replay.replay(bytes.data(), bytes.size());
+    assert(replay.stats().malformed == 1 && !replay.stats().truncated);
+    // Cut the next message short
+    ItchWriter more;
+    more.remove(1, 1);
+    replay.replay(more.bytes.data(), more.bytes.size() - 4);
+    assert(replay.stats().truncated);
+    assert(replay.book("AAA")->getBuyOrders().size() == 1);
+}
+
+void test_out_of_range_shares() {
+    ItchWriter w;
+    w.addOrder(1, 1, 1, 'B', 100, "AAA", 10000);
+    // Share counts that do not fit an int, or are zero, must not reach the book
+    w.executed(1, 1, 0x80000000u);
+    w.cancel(1, 1, 0xFFFFFFFFu);
+    w.executedWithPrice(1, 1, 0, 10000);
+    w.addOrder(1, 2, 2, 'B', 0x80000000u, "AAA", 10000);
+    ItchReplay<LeanBook> replay;
+    replay.replay(w.bytes.data(), w.bytes.size());
+    const ItchStats& s = replay.stats();
+    assert(s.malformed == 4 && s.executions == 0 && s.cancels == 0 && s.adds == 1);
+    std::vector<Order> bids = replay.book("AAA")->getBuyOrders();
+    assert(bids.size() == 1 && bids[0].getQuantity() == 100);
+}
+
+void test_duplicate_refs_are_rejected() {
+    ItchWriter w;
+    w.addOrder(1, 1, 1, 'B', 100, "AAA", 10000);
+    w.addOrder(1, 2, 2, 'S', 50, "AAA", 11000);
+    // Reusing a live reference, by add or by replace, leaves both orders as they were
+    w.addOrder(1, 3, 1, 'B', 30, "AAA", 10500);
+    w.replace(1, 2, 1, 20, 10800);
+    ItchReplay<LeanBook> replay;
+    replay.replay(w.bytes.data(), w.bytes.size());
+    const ItchStats& s = replay.stats();
+    assert(s.malformed == 2 && s.adds == 2 && s.replaces == 0);
+    LeanBook* book = replay.book("AAA");
+    std::vector<Order> bids = book->getBuyOrders();
+    std::vector<Order> asks = book->getSellOrders();
+    assert(bids.size() == 1 && bids[0].getQuantity() == 100 && bids[0].getPrice() == 1.0);
+    assert(asks.size() == 1 && asks[0].getQuantity() == 50);
+    // Both references still reach their own orders
+    ItchWriter more;
+    more.remove(1, 1);
+    more.executed(1, 2, 50);
+    replay.replay(more.bytes.data(), more.bytes.size());
+    assert(book->getBuyOrders().empty() && book->getSellOrders().empty());
+    // A deleted reference may be used again
+    ItchWriter again;
+    again.addOrder(1, 4, 1, 'B', 10, "AAA", 10000);
+    replay.replay(again.bytes.data(), again.bytes.size());
+    assert(book->getBuyOrders().size() == 1 && replay.stats().malformed == 2);
+}
+
+int main() {
+    test_replay_rebuilds_books();
+    test_symbol_filter_and_file();
+    test_queue_priority_survives_partial_execution();
+    test_truncated_and_malformed();
+    test_out_of_range_shares();
+    test_duplicate_refs_are_rejected();
+    std::cout << "ITCH replay tests passed!\n";
+    return 0;
+}
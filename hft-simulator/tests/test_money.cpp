@@ -0,0 +1,138 @@
+#include "Money.h"
+#include "TradeLogger.h"
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string>
+
+void test_money_arithmetic() {
+    Money price = Money::fromPrice(100.07);
+    assert(price.ticks() == 1000700);
+    assert((price * 3).ticks() == 3002100);
+    assert((price * 3 - price).ticks() == 2001400);
+    assert((-price).ticks() == -1000700);
+    assert(Money::fromPrice(0.1).toDouble() == 0.1);
+    // 0.1 + 0.2 is exact in ticks
+    assert(Money::fromPrice(0.1) + Money::fromPrice(0.2) == Money::fromPrice(0.3));
+
+    // 7 ticks split in thirds truncates toward zero without losing the remainder
+    Money seven = Money::fromTicks(7);
+    assert(seven.scaled(1, 3).ticks() == 2);
+    assert(Money::fromTicks(-7).scaled(1, 3).ticks() == -2);
+    Money large = Money::fromTicks(std::numeric_limits<std::int64_t>::max() / 2);
+    assert(large.scaled(3, 4).ticks() == std::numeric_limits<std::int64_t>::max() / 2 / 4 * 3 + 3 * 3 / 4);
+    assert(!large.scaled(3, 4).overflowed());
+}
+
+void test_overflow_is_sticky() {
+    Money big = Money::fromTicks(std::numeric_limits<std::int64_t>::max() - 1);
+    Money sum = big + Money::fromTicks(5);
+    assert(sum.overflowed());
+    assert((sum - Money::fromTicks(5)).overflowed());
+    assert((big * 2).overflowed());
+    assert(!(big * 1).overflowed());
+    assert(Money::fromPrice(1e20).overflowed());
+    Money total;
+    total += sum;
+    assert(total.overflowed());
+}
+
+void test_position_is_exact() {
+    Position position;
+    Money a = Money::fromPrice(100.10);
+    Money b = Money::fromPrice(100.20);
+    Money c = Money::fromPrice(100.30);
+    position.update(1, a, true);
+    position.update(1, b, true);
+    position.update(1, c, true);
+    // Average 100.2; selling one at 100.25 realizes 0.05
+    position.update(1, Money::fromPrice(100.25), false);
+    assert(position.realized_pnl == Money::fromPrice(0.05));
+    assert(position.net_quantity == 2);
+    position.mark_to_market(Money::fromPrice(101.0));
+    assert(position.unrealized_pnl == Money::fromPrice(1.6));
+    // Flipping short closes the rest at its cost and opens the short at the trade price
+    position.update(5, Money::fromPrice(100.0), false);
+    assert(position.net_quantity == -3);
+    assert(position.realized_pnl == Money::fromPrice(0.05 - 0.4));
+    assert(position.cost_basis == Money::fromPrice(300.0));
+    assert(position.average_price() == 100.0);
+    position.update(3, Money::fromPrice(99.5), true);
+    assert(position.net_quantity == 0 && position.cost_basis == Money());
+    assert(position.realized_pnl == Money::fromPrice(-0.35 + 1.5));
+}
+
+// Uneven cost splits leave remainders in the basis; flat again, P&L equals the cash flow
+void test_round_trips_do_not_drift() {
+    Position position;
+    Money cash;
+    std::uint64_t seed = 7;
+    for (int i = 0; i < 1000000; ++i) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        Money price = Money::fromTicks(1000000 + static_cast<std::int64_t>((seed >> 33) % 20000));
+        int qty = 1 + static_cast<int>((seed >> 20) % 7);
+        bool buy = (seed >> 62) & 1;
+        position.update(qty, price, buy);
+        if (buy) cash -= price * qty;
+        else cash += price * qty;
+    }
+    Money close = Money::fromTicks(1005000);
+    int remaining = position.net_quantity;
+    if (remaining > 0) {
+        position.update(remaining, close, false);
+        cash += close * remaining;
+    } else if (remaining < 0) {
+        position.update(-remaining, close, true);
+        cash -= close * -remaining;
+    }
+    assert(position.net_quantity == 0);
+    assert(position.realized_pnl == cash);
+    assert(!cash.overflowed());
+}
+
+void test_logger_reports_exact_pnl() {
+    TradeLogger logger("/tmp/hft_money_test.col", TradeOutputFormat::COLUMNAR);
+    for (int i = 0; i < 10; ++i) {
+        Trade buy = {1, 2, 0.1, 1, "", "BUY", 0, 0, 0};
+        logger.logTrade(buy);
+    }
+    Trade sell = {3, 4, 0.3, 10, "", "SELL", 0, 0, 0};
+    logger.logTrade(sell);
+    // Ten buys at 0.1 sum to exactly 1.0 in ticks
+    assert(logger.getPosition().realized_pnl == Money::fromPrice(2.0));
+    assert(logger.getRealizedPnL() == 2.0);
+    assert(logger.getExactAggressorPnL() == Money::fromPrice(2.0));
+    assert(logger.getNetPosition() == 0 && logger.getUnrealizedPnL() == 0.0);
+}
+
+void test_csv_summary_flags_overflow() {
+    const char* path = "/tmp/hft_money_test.csv";
+    {
+        TradeLogger logger(path);
+        Trade buy = {1, 2, 1e14, 1000, "", "BUY", 0, 0, 0};
+        logger.logTrade(buy);
+    }
+    std::ifstream in(path);
+    std::string line;
+    bool flagged = false;
+    while (std::getline(in, line)) {
+        if (line.compare(0, 8, "Warning,") == 0) flagged = true;
+    }
+    assert(flagged);
+    std::remove(path);
+}
+
+int main() {
+    test_money_arithmetic();
+    test_overflow_is_sticky();
+    test_position_is_exact();
+    test_round_trips_do_not_drift();
+    test_logger_reports_exact_pnl();
+    test_csv_summary_flags_overflow();
+    std::remove("/tmp/hft_money_test.col");
+    std::cout << "Money tests passed!\n";
+    return 0;
+}
@@ -30,10 +30,18 @@ void test_order_sideToString() {
     assert(Order::sideToString(Order::Side::SELL) == "SELL");
 }
 
+void test_order_owner() {
+    Order o(1, Order::Side::BUY, 1.0, 1, 1);
+    assert(o.getOwnerID() == 0);
+    o.setOwnerID(7);
+    assert(o.getOwnerID() == 7);
+}
+
 int main() {
     test_order_constructor_and_accessors();
     test_order_mutators();
     test_order_sideToString();
+    test_order_owner();
     std::cout << "Order class tests passed!\n";
     return 0;
 } 
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "OrderBook.h"
 #include <cassert>
 #include <iostream>
+#include <vector>
 
 void test_add_and_cancel_order() {
     OrderBook ob;
@@ -59,12 +60,199 @@ void test_match_orders_empty_book() {
     assert(ob.getSellOrders().empty());
 }
 
+Order owned(int id, Order::Side side, double price, int qty, int owner) {
+    Order o(id, side, price, qty, id);
+    o.setOwnerID(owner);
+    return o;
+}
+
+void test_add_orders_batch_matches_once() {
+    OrderBook ob;
+    std::vector<Order> batch;
+    batch.push_back(Order(1, Order::Side::BUY, 101.0, 10, 1));
+    batch.push_back(Order(2, Order::Side::SELL, 100.0, 4, 2));
+    batch.push_back(Order(3, Order::Side::SELL, 102.0, 5, 3));
+    ob.addOrders(batch);
+    auto buys = ob.getBuyOrders();
+    assert(buys.size() == 1);
+    assert(buys[0].getQuantity() == 6);
+    auto sells = ob.getSellOrders();
+    assert(sells.size() == 1);
+    assert(sells[0].getOrderID() == 3);
+}
+
+void test_cancel_all_by_owner() {
+    OrderBook ob;
+    ob.addOrder(owned(1, Order::Side::BUY, 99.0, 1, 7));
+    ob.addOrder(owned(2, Order::Side::BUY, 99.0, 1, 8));
+    ob.addOrder(owned(3, Order::Side::SELL, 101.0, 1, 7));
+    ob.addOrder(owned(4, Order::Side::SELL, 102.0, 1, 7));
+    Order stop(5, Order::Side::BUY, 0.0, 1, 5, 105.0);
+    stop.setOwnerID(7);
+    ob.addOrder(stop);
+    assert(ob.cancelAll(7) == 4);
+    auto buys = ob.getBuyOrders();
+    assert(buys.size() == 1 && buys[0].getOrderID() == 2);
+    assert(ob.getSellOrders().empty());
+    assert(!ob.cancelOrder(1));
+    assert(ob.cancelOrder(2));
+}
+
+void test_cancel_side() {
+    OrderBook ob;
+    ob.addOrder(Order(1, Order::Side::BUY, 99.0, 1, 1));
+    ob.addOrder(Order(2, Order::Side::BUY, 98.0, 1, 2));
+    ob.addOrder(Order(3, Order::Side::SELL, 101.0, 1, 3));
+    assert(ob.cancelSide(Order::Side::BUY) == 2);
+    assert(ob.getBuyOrders().empty());
+    assert(ob.getSellOrders().size() == 1);
+    // The side remains usable afterwards
+    ob.addOrder(Order(4, Order::Side::BUY, 101.0, 1, 4));
+    ob.matchOrders();
+    assert(ob.getBuyOrders().empty());
+    assert(ob.getSellOrders().empty());
+
+    // Market orders held by an auction go with their side
+    ob.beginAuction();
+    ob.addOrder(Order(5, Order::Side::BUY, 0.0, 2, 5, Order::OrderType::MARKET));
+    ob.addOrder(Order(6, Order::Side::SELL, 0.0, 3, 6, Order::OrderType::MARKET));
+    ob.addOrder(Order(7, Order::Side::BUY, 100.0, 1, 7));
+    ob.addOrder(Order(8, Order::Side::SELL, 100.0, 1, 8));
+    assert(ob.cancelSide(Order::Side::BUY) == 2);
+    assert(!ob.cancelOrder(5));
+    // Only the sell side is left to uncross, so nothing trades
+    assert(ob.uncross().volume == 0);
+    assert(ob.getSellOrders().size() == 1);
+    assert(!ob.cancelOrder(6));
+}
+
+void test_cancel_range() {
+    OrderBook ob;
+    for (int i = 0; i < 5; ++i) {
+        ob.addOrder(Order(i + 1, Order::Side::BUY, 95.0 + i, 1, i));
+        ob.addOrder(Order(i + 11, Order::Side::SELL, 101.0 + i, 1, i));
+    }
+    assert(ob.cancelRange(Order::Side::BUY, 96.0, 98.0) == 3);
+    auto buys = ob.getBuyOrders();
+    assert(buys.size() == 2);
+    assert(buys[0].getPrice() == 99.0 && buys[1].getPrice() == 95.0);
+    assert(ob.cancelRange(Order::Side::SELL, 104.0, 110.0) == 2);
+    assert(ob.getSellOrders().size() == 3);
+    assert(ob.cancelRange(Order::Side::SELL, 110.0, 104.0) == 0);
+}
+
+void test_queue_position() {
+    OrderBook ob;
+    ob.addOrder(Order(1, Order::Side::BUY, 100.0, 5, 1));
+    ob.addOrder(Order(2, Order::Side::BUY, 100.0, 3, 2));
+    ob.addOrder(Order(3, Order::Side::BUY, 100.0, 4, 3));
+    ob.addOrder(Order(4, Order::Side::BUY, 99.0, 6, 4));
+    assert(ob.queuePosition(1) == 0);
+    assert(ob.queuePosition(2) == 5);
+    assert(ob.queuePosition(3) == 8);
+    assert(ob.queuePosition(4) == 0);
+    assert(ob.queuePosition(999) == -1);
+    // Partial fill of the front order
+    ob.addOrder(Order(5, Order::Side::SELL, 100.0, 2, 5));
+    ob.matchOrders();
+    assert(ob.queuePosition(1) == 0);
+    assert(ob.queuePosition(2) == 3);
+    assert(ob.queuePosition(3) == 6);
+    // Cancel from the middle of the queue
+    assert(ob.cancelOrder(2));
+    assert(ob.queuePosition(3) == 3);
+    // Fill through the front order into the next one
+    ob.addOrder(Order(6, Order::Side::SELL, 100.0, 4, 6));
+    ob.matchOrders();
+    assert(ob.queuePosition(1) == -1);
+    assert(ob.queuePosition(3) == 0);
+    ob.addOrder(Order(7, Order::Side::BUY, 100.0, 1, 7));
+    assert(ob.queuePosition(7) == 3);
+    // Owner cancels keep the queue consistent
+    Order mine(8, Order::Side::BUY, 100.0, 2, 8);
+    mine.setOwnerID(9);
+    ob.addOrder(mine);
+    ob.addOrder(Order(9, Order::Side::BUY, 100.0, 1, 9));
+    assert(ob.queuePosition(9) == 6);
+    assert(ob.cancelAll(9) == 1);
+    assert(ob.queuePosition(9) == 4);
+}
+
+void test_level_queue_compacts() {
+    // A busy level that never empties: orders keep joining at the back and trading at the
+    // front. The tree must stay sized to the resting orders, with positions still exact.
+    struct Resting {
+        std::size_t seq;
+        std::int64_t quantity;
+    };
+    LevelQueue queue;
+    std::vector<Resting> live;
+    std::size_t front = 0;
+    std::uint32_t rng = 12345;
+    for (int step = 0; step < 200000; ++step) {
+        rng = rng * 1664525u + 1013904223u;
+        std::int64_t quantity = 1 + (rng >> 16) % 9;
+        live.push_back(Resting{queue.append(quantity), quantity});
+        if (step % 7 == 3 && live.size() - front > 2) {
+            // Cancel one from the middle
+            Resting& victim = live[front + 1];
+            queue.cancel(victim.seq, victim.quantity);
+            victim.quantity = 0;
+        }
+        // Trade about as much as arrived, from the front
+        std::int64_t traded = quantity - (step % 5 == 0 ? 1 : 0);
+        while (traded > 0 && front < live.size()) {
+            Resting& head = live[front];
+            std::int64_t take = std::min(traded, head.quantity);
+            queue.consume(take);
+            head.quantity -= take;
+            traded -= take;
+            if (head.quantity == 0) ++front;
+        }
+        while (front < live.size() && live[front].quantity == 0) ++front;
+        if (step % 997 == 0) {
+            std::int64_t ahead = 0;
+            for (std::size_t i = front; i < live.size(); ++i) {
+                if (live[i].quantity == 0) continue;
+                assert(queue.ahead(live[i].seq) == (i == front ? 0 : ahead));
+                ahead += live[i].quantity;
+            }
+            assert(queue.resting() == ahead);
+        }
+        assert(queue.capacity() <= 2 * (live.size() - front) + 128);
+    }
+}
+
+void test_empty_orders_do_not_rest() {
+    BasicOrderBook<NullEventSink, SimulatedClock> ob;
+    for (int i = 0; i < 32; ++i) {
+        ob.addOrder(Order(i, Order::Side::BUY, 100.0, 0, i));
+    }
+    // Enough appends to trigger a compaction check at the level
+    for (int i = 32; i < 65; ++i) {
+        ob.addOrder(Order(i, Order::Side::BUY, 100.0, 1, i));
+    }
+    assert(ob.queuePosition(0) == -1);
+    assert(ob.queuePosition(32) == 0 && ob.queuePosition(64) == 32);
+    assert(ob.getBuyOrders().size() == 33);
+    assert(!ob.cancelOrder(0));
+    ob.addOrder(Order(100, Order::Side::SELL, 0.0, -5, 100, Order::OrderType::MARKET));
+    assert(ob.getBuyOrders().size() == 33);
+}
+
 int main() {
     test_add_and_cancel_order();
     test_match_orders_full_fill();
     test_match_orders_partial_fill();
     test_match_orders_no_match();
     test_match_orders_empty_book();
+    test_add_orders_batch_matches_once();
+    test_cancel_all_by_owner();
+    test_cancel_side();
+    test_cancel_range();
+    test_queue_position();
+    test_level_queue_compacts();
+    test_empty_orders_do_not_rest();
     std::cout << "OrderBook class tests passed!\n";
     return 0;
 } 
\ No newline at end of file
@@ -0,0 +1,218 @@
+#include "CpuAffinity.h"
+#include "HugePageArena.h"
+#include "RuntimeConfig.h"
+#include "StrategyEngine.h"
+#include "BasicOrderBook.h"
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+void test_load_runtime_config() {
+    const char* path = "test_runtime.cfg";
+    {
+        std::ofstream out(path);
+        out << "# production placement\n"
+            << "engine_thread = 1\n"
+            << "matching_cpu=3\n"
+            << "busy_poll=true  # spin\n"
+            << "arena_mb=64\n"
+            << "huge_pages=0\n"
+            << "order_entry_latency = normal 20000 1500\n"
+            << "market_data_latency=sideways 5000\n"
+            << "latency_seed=7\n"
+            << "unknown=5\n";
+    }
+    RuntimeConfig config = loadRuntimeConfig(path);
+    std::remove(path);
+    assert(config.engine_thread);
+    assert(config.matching_cpu == 3);
+    assert(config.busy_poll);
+    assert(config.arena_bytes == (std::size_t(64) << 20));
+    assert(!config.huge_pages);
+    assert(config.prefault);
+    assert(config.numa_node == -1);
+    assert(config.simulate_latency);
+    assert(config.latency.order_entry.kind == LatencyDistribution::Kind::NORMAL);
+    assert(config.latency.order_entry.base_ns == 20000 && config.latency.order_entry.jitter_ns == 1500.0);
+    // A bad distribution is ignored, leaving the default
+    assert(config.latency.market_data.kind == LatencyDistribution::Kind::CONSTANT && config.latency.market_data.base_ns == 0);
+    assert(config.latency.seed == 7 && config.latency.tick_ns == 1000);
+
+    RuntimeConfig defaults = loadRuntimeConfig("does_not_exist.cfg");
+    assert(!defaults.engine_thread && defaults.matching_cpu == -1 && defaults.arena_bytes == 0);
+    assert(!defaults.simulate_latency);
+}
+
+void test_pinning() {
+    assert(!pinCurrentThread(-1));
+#ifdef __linux__
+    int cpu = currentCpu();
+    assert(cpu >= 0);
+    // The CPU we are already on is always allowed
+    assert(pinCurrentThread(cpu));
+    assert(currentCpu() == cpu);
+    assert(numaNodeOfCpu(cpu) >= 0);
+#endif
+}
+
+void test_arena_allocation() {
+    HugePageArena arena(1 << 20, -1, true, true);
+    assert(arena.capacity() >= (std::size_t(1) << 20));
+    void* a = arena.allocate(100, 64);
+    void* b = arena.allocate(8, 4096);
+    assert(a && b && a != b);
+    assert(reinterpret_cast<std::uintptr_t>(a) % 64 == 0);
+    assert(reinterpret_cast<std::uintptr_t>(b) % 4096 == 0);
+    assert(arena.contains(a) && arena.contains(b));
+    assert(arena.allocate(arena.capacity(), 8) == nullptr);
+}
+
+void test_pool_nodes_come_from_arena() {
+    HugePageArena arena(std::size_t(8) << 20, numaNodeOfCpu(currentCpu()), true, true);
+    struct Payload { char bytes[72]; };
+    PoolAllocator<Payload> alloc(&arena);
+    Payload* p = alloc.allocate(1);
+    assert(arena.contains(p));
+    alloc.deallocate(p, 1);
+    // A freed block goes back to its own arena, not to the thread's pool
+    assert(alloc.allocate(1) == p);
+    PoolAllocator<Payload> heap;
+    Payload* q = heap.allocate(1);
+    assert(!arena.contains(q));
+    heap.deallocate(q, 1);
+    alloc.deallocate(p, 1);
+    // Book nodes from a pooled book land in the arena as well
+    BasicOrderBook<NullEventSink, SimulatedClock, TickPrice<100>, PoolStorage> book;
+    assert(book.useChunkSource(&arena));
+    for (int i = 0; i < 1000; ++i) {
+        book.addOrder(Order(i, Order::Side::SELL, 100.0 + (i % 50) * 0.01, 1, i));
+    }
+    assert(arena.used() > 0);
+    assert(book.getSellOrders().size() == 1000);
+    assert(!book.useChunkSource(nullptr));
+}
+
+// Nodes an arena book frees are never handed to another book, so they cannot outlive it
+void test_arena_nodes_stay_with_their_book() {
+    std::unique_ptr<OrderBook> first(new OrderBook);
+    assert(first->attachArena(std::unique_ptr<HugePageArena>(new HugePageArena(std::size_t(1) << 20, -1, false, false))));
+    for (int i = 0; i < 200; ++i) {
+        first->addOrder(Order(i, Order::Side::SELL, 100.0 + (i % 20) * 0.01, 1, i));
+    }
+    for (int i = 0; i < 200; ++i) {
+        assert(first->cancelOrder(i));
+    }
+    OrderBook second;
+    for (int i = 0; i < 200; ++i) {
+        second.addOrder(Order(i, Order::Side::SELL, 100.0 + (i % 20) * 0.01, 1, i));
+    }
+    first.reset();
+    std::vector<Order> sells = second.getSellOrders();
+    assert(sells.size() == 200);
+    for (std::size_t i = 0; i < sells.size(); ++i) assert(sells[i].getQuantity() == 1);
+
+    // A book with resting orders keeps its nodes where they are
+    assert(!second.attachArena(std::unique_ptr<HugePageArena>(new HugePageArena(std::size_t(1) << 20, -1, false, false))));
+    assert(second.arena() == nullptr);
+}
+
+struct CountingStrategy : Strategy {
+    std::atomic<int> steps{0};
+    void step() override { ++steps; }
+};
+
+void test_engine_thread_busy_poll() {
+    OrderBook ob;
+    StrategyEngine engine(ob, 0.5, 1);
+    CountingStrategy* counter = new CountingStrategy;
+    engine.addStrategy(std::unique_ptr<Strategy>(counter));
+    RuntimeConfig config;
+    config.engine_thread = true;
+    config.busy_poll = true;
+    config.matching_cpu = currentCpu();
+    config.arena_bytes = std::size_t(2) << 20;
+    engine.setRuntimeConfig(config);
+    engine.start();
+    assert(engine.isRunning());
+    while (counter->steps < 5) {
+        std::this_thread::yield();
+    }
+    engine.stop();
+    assert(!engine.isRunning());
+    int after_stop = counter->steps;
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    assert(counter->steps == after_stop);
+}
+
+// Quotes one order per tick from the engine thread
+struct QuotingStrategy : Strategy {
+    std::atomic<int> sent{0};
+    void step() override {
+        if (sent < 100) {
+            int id = 1000 + sent++;
+            sendOrder(makeOrder(id, Order::Side::BUY, 90.0 + (id % 20) * 0.25, 1));
+        }
+    }
+};
+
+void test_engine_arena_backs_book() {
+    {
+        OrderBook ob;
+        {
+            StrategyEngine engine(ob, 0.5, 0);
+            QuotingStrategy* quoter = new QuotingStrategy;
+            engine.addStrategy(std::unique_ptr<Strategy>(quoter));
+            RuntimeConfig config;
+            config.engine_thread = true;
+            config.arena_bytes = std::size_t(4) << 20;
+            engine.setRuntimeConfig(config);
+            engine.start();
+            while (quoter->sent < 100) {
+                std::this_thread::yield();
+            }
+            engine.stop();
+        }
+        // The engine is gone; the book keeps the arena its nodes live in
+        assert(ob.arena() != nullptr && ob.arena()->used() > 0);
+        std::vector<Order> buys = ob.getBuyOrders();
+        assert(buys.size() == 100);
+        for (std::size_t i = 0; i < buys.size(); ++i) assert(buys[i].getQuantity() == 1);
+        assert(ob.cancelSide(Order::Side::BUY) == 100);
+        ob.addOrder(Order(1, Order::Side::SELL, 101.0, 1, 1));
+    }
+    // Nodes the book freed went back to its arena alone; a new book on this thread is unaffected
+    OrderBook next;
+    for (int i = 0; i < 1000; ++i) {
+        next.addOrder(Order(i, Order::Side::SELL, 100.0 + (i % 50) * 0.01, 1, i));
+    }
+    assert(next.getSellOrders().size() == 1000);
+}
+
+void test_engine_run_steps_strategies() {
+    OrderBook ob;
+    StrategyEngine engine(ob, 0.5, 100);
+    CountingStrategy* counter = new CountingStrategy;
+    engine.addStrategy(std::unique_ptr<Strategy>(counter));
+    engine.run();
+    engine.run();
+    assert(counter->steps == 2);
+    assert(!engine.isRunning());
+}
+
+int main() {
+    test_load_runtime_config();
+    test_pinning();
+    test_arena_allocation();
+    test_pool_nodes_come_from_arena();
+    test_arena_nodes_stay_with_their_book();
+    test_engine_thread_busy_poll();
+    test_engine_arena_backs_book();
+    test_engine_run_steps_strategies();
+    std::cout << "Runtime placement tests passed!\n";
+    return 0;
+}
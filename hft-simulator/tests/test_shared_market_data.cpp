@@ -0,0 +1,191 @@
+#include "SharedMarketData.h"
+#include "BasicOrderBook.h"
+#include <atomic>
+#include <cassert>
+#include <fcntl.h>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// Forwards book events to a publisher, like ListenerSink does for OrderBook
+struct PublishingSink : NullEventSink {
+    MarketDataPublisher* publisher = nullptr;
+    void onFill(const Fill& fill) { publisher->onFill(fill); }
+    void onLevelChange(const LevelUpdate& update) { publisher->onLevelChange(update); }
+    void onBookState(const BookState& state) { publisher->onBookState(state); }
+};
+
+using PublishingBook = BasicOrderBook<PublishingSink, SimulatedClock>;
+
+std::string regionName(const char* tag) {
+    return std::string("hft_md_test_") + tag + "_" + std::to_string(getpid());
+}
+
+void test_book_events_reach_reader() {
+    std::string name = regionName("book");
+    MarketDataPublisher publisher(name, 64);
+    assert(publisher.isOpen());
+    PublishingSink sink;
+    sink.publisher = &publisher;
+    PublishingBook book(sink);
+    MarketDataReader reader(name);
+    assert(reader.isOpen());
+
+    book.addOrder(Order(1, Order::Side::BUY, 100.0, 10, 1));
+    book.addOrder(Order(2, Order::Side::SELL, 100.5, 5, 2));
+    book.addOrder(Order(3, Order::Side::SELL, 100.0, 4, 3));
+    book.matchOrders();
+
+    TopOfBookSnapshot top;
+    assert(reader.topOfBook(top));
+    assert(top.bid_price == 100.0 && top.bid_quantity == 6);
+    assert(top.ask_price == 100.5 && top.ask_quantity == 5);
+
+    std::vector<BroadcastRecord> records;
+    BroadcastRecord r;
+    while (reader.poll(r)) records.push_back(r);
+    // Three level adds, then the trade and both levels it touched
+    assert(records.size() == 6);
+    for (std::size_t i = 0; i < records.size(); ++i) assert(records[i].sequence == i + 1);
+    assert(records[0].kind == BroadcastKind::LEVEL && records[0].side == Order::Side::BUY && records[0].quantity == 10);
+    assert(records[3].kind == BroadcastKind::TRADE && records[3].price == 100.0 && records[3].quantity == 4);
+    assert(records[3].buy_order_id == 1 && records[3].sell_order_id == 3 && records[3].side == Order::Side::SELL);
+    assert(records[4].side == Order::Side::BUY && records[4].quantity == 6);
+    assert(records[5].side == Order::Side::SELL && records[5].price == 100.0 && records[5].quantity == 0);
+    assert(reader.lost() == 0);
+
+    book.cancelOrder(2);
+    assert(reader.poll(r) && r.kind == BroadcastKind::LEVEL && r.quantity == 0 && r.price == 100.5);
+    assert(reader.topOfBook(top) && top.ask_price == 0.0);
+    assert(!reader.poll(r));
+}
+
+void test_slow_reader_sees_gap() {
+    std::string name = regionName("gap");
+    MarketDataPublisher publisher(name, 8);
+    MarketDataReader reader(name);
+    for (int i = 1; i <= 20; ++i) {
+        publisher.onLevelChange(LevelUpdate{Order::Side::BUY, 100.0, i});
+    }
+    BroadcastRecord r;
+    assert(reader.poll(r));
+    // Only the last 8 of 20 survive
+    assert(r.sequence == 13 && r.quantity == 13);
+    assert(reader.lost() == 12);
+    int seen = 1;
+    while (reader.poll(r)) ++seen;
+    assert(seen == 8 && r.sequence == 20);
+
+    MarketDataReader late(name);
+    late.seekToLatest();
+    assert(!late.poll(r));
+    assert(!MarketDataReader(regionName("missing")).isOpen());
+}
+
+// Writer thread hammers a small ring and the snapshot; readers must never see a torn value
+void test_concurrent_reader_consistency() {
+    std::string name = regionName("race");
+    MarketDataPublisher publisher(name, 16);
+    MarketDataReader reader(name);
+    const int kRecords = 200000;
+    std::atomic<bool> done(false);
+    std::thread writer([&]() {
+        for (int i = 1; i <= kRecords; ++i) {
+            // Every field derived from i, so a mix of two records is detectable
+            Fill fill = {i, -i, static_cast<double>(i) * 0.5, i, static_cast<std::uint64_t>(i) * 3, Order::Side::BUY, false, 0, 0};
+            publisher.onFill(fill);
+            BookState state = {0, 0, 0, 0, 0, 0, static_cast<double>(i), i, static_cast<double>(i) + 1, i * 2};
+            publisher.onBookState(state);
+        }
+        done = true;
+    });
+    std::uint64_t last = 0;
+    std::uint64_t received = 0;
+    while (!done || last < publisher.published()) {
+        BroadcastRecord r;
+        if (reader.poll(r)) {
+            assert(r.sequence > last);
+            last = r.sequence;
+            ++received;
+            int i = static_cast<int>(r.quantity);
+            assert(r.buy_order_id == i && r.sell_order_id == -i);
+            assert(r.price == i * 0.5 && r.timestamp == static_cast<std::uint64_t>(i) * 3);
+        }
+        // false only if the writer was descheduled mid-update for the whole stall limit
+        TopOfBookSnapshot top;
+        if (reader.topOfBook(top)) {
+            assert(top.ask_price == top.bid_price + 1 || top.sequence == 0);
+            assert(top.ask_quantity == top.bid_quantity * 2);
+        }
+    }
+    writer.join();
+    assert(last == kRecords);
+    assert(received + reader.lost() == kRecords);
+}
+
+// A separate process maps the same region
+void test_reader_in_other_process() {
+    std::string name = regionName("fork");
+    MarketDataPublisher publisher(name, 64);
+    publisher.onLevelChange(LevelUpdate{Order::Side::SELL, 101.25, 7});
+    pid_t child = fork();
+    if (child == 0) {
+        MarketDataReader reader(name);
+        BroadcastRecord r;
+        bool ok = reader.isOpen() && reader.poll(r) && r.price == 101.25 && r.quantity == 7 && r.side == Order::Side::SELL;
+        _exit(ok ? 0 : 1);
+    }
+    int status = 0;
+    waitpid(child, &status, 0);
+    assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+}
+
+// A restarted publisher replaces the region; readers of the old one neither fault nor
+// hang, even on a snapshot its writer left half-written
+void test_restart_and_dead_writer() {
+    std::string name = regionName("restart");
+    std::unique_ptr<MarketDataPublisher> first(new MarketDataPublisher(name, 64));
+    first->onLevelChange(LevelUpdate{Order::Side::BUY, 99.0, 3});
+    first->onBookState(BookState{0, 0, 0, 0, 0, 0, 99.0, 3, 0.0, 0});
+    MarketDataReader old_reader(name);
+    assert(old_reader.isOpen());
+
+    // Leave the old snapshot odd, as a writer killed mid-update would (the seqlock word
+    // follows the 64-byte region header)
+    int fd = open(("/dev/shm/" + name).c_str(), O_RDWR);
+    assert(fd >= 0);
+    std::uint64_t odd = 7;
+    assert(pwrite(fd, &odd, sizeof(odd), 64) == static_cast<ssize_t>(sizeof(odd)));
+    close(fd);
+    TopOfBookSnapshot top = {};
+    assert(!old_reader.topOfBook(top) && top.sequence == 0);
+
+    // A bigger ring under the same name; the old mapping stays readable
+    MarketDataPublisher second(name, 1024);
+    assert(second.isOpen());
+    BroadcastRecord r;
+    assert(old_reader.poll(r) && r.price == 99.0 && r.quantity == 3);
+    second.onLevelChange(LevelUpdate{Order::Side::SELL, 101.0, 4});
+    MarketDataReader new_reader(name);
+    assert(new_reader.isOpen());
+    assert(new_reader.poll(r) && r.price == 101.0 && r.sequence == 1);
+    assert(new_reader.topOfBook(top) && top.sequence == 0);
+
+    // The old publisher going away must not remove its successor's region
+    first.reset();
+    assert(MarketDataReader(name).isOpen());
+}
+
+int main() {
+    test_book_events_reach_reader();
+    test_slow_reader_sees_gap();
+    test_concurrent_reader_consistency();
+    test_reader_in_other_process();
+    test_restart_and_dead_writer();
+    std::cout << "Shared market data tests passed!\n";
+    return 0;
+}
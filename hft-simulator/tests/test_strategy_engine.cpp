@@ -0,0 +1,188 @@
+#include "StrategyEngine.h"
+#include <cassert>
+#include <iostream>
+#include <vector>
+
+// Records every callback; optionally quotes a bid on its first top-of-book event
+struct RecordingStrategy : Strategy {
+    OrderBook* book = nullptr;
+    bool quote = false;
+    std::vector<TopOfBook> tops;
+    std::vector<TradeEvent> trades;
+    std::vector<OwnFill> fills;
+
+    void onTopOfBookChange(const TopOfBook& top) override {
+        tops.push_back(top);
+        if (quote && book) {
+            quote = false;
+            book->addOrder(makeOrder(500, Order::Side::BUY, 99.0, 10));
+        }
+    }
+    void onTrade(const TradeEvent& trade) override { trades.push_back(trade); }
+    void onOwnFill(const OwnFill& fill) override { fills.push_back(fill); }
+};
+
+void test_top_of_book_changes() {
+    OrderBook ob;
+    StrategyEngine engine(ob, 0.5, 100);
+    RecordingStrategy* s = new RecordingStrategy;
+    engine.addStrategy(std::unique_ptr<Strategy>(s));
+    assert(s->getOwnerID() == 1);
+    // Initial snapshot of the empty book
+    assert(s->tops.size() == 1 && s->tops[0].bid_price == 0.0 && s->tops[0].ask_price == 0.0);
+
+    ob.addOrder(Order(1, Order::Side::BUY, 100.0, 10, 1));
+    assert(s->tops.size() == 2 && s->tops[1].bid_price == 100.0 && s->tops[1].bid_quantity == 10);
+    // Behind the best bid: no change, no callback
+    ob.addOrder(Order(2, Order::Side::BUY, 99.0, 5, 2));
+    assert(s->tops.size() == 2);
+    // Quantity at the best level changes
+    ob.addOrder(Order(3, Order::Side::BUY, 100.0, 7, 3));
+    assert(s->tops.size() == 3 && s->tops[2].bid_quantity == 17);
+    ob.addOrder(Order(4, Order::Side::SELL, 101.0, 4, 4));
+    assert(s->tops.size() == 4 && s->tops[3].ask_price == 101.0 && s->tops[3].ask_quantity == 4);
+    ob.cancelOrder(1);
+    assert(s->tops.size() == 5 && s->tops[4].bid_quantity == 7);
+    // Idle book: matching with nothing crossing delivers nothing
+    engine.run();
+    assert(s->tops.size() == 5 && s->trades.empty());
+}
+
+void test_trades_and_own_fills() {
+    OrderBook ob;
+    StrategyEngine engine(ob, 0.5, 100);
+    RecordingStrategy* a = new RecordingStrategy;
+    RecordingStrategy* b = new RecordingStrategy;
+    a->book = &ob;
+    a->quote = true;
+    engine.addStrategy(std::unique_ptr<Strategy>(a));
+    engine.addStrategy(std::unique_ptr<Strategy>(b));
+    assert(b->getOwnerID() == 2);
+    // a quoted from inside its first callback
+    assert(ob.queuePosition(500) == 0);
+
+    ob.addOrder(Order(1, Order::Side::SELL, 99.0, 4, 1));
+    ob.matchOrders();
+    assert(a->trades.size() == 1 && b->trades.size() == 1);
+    assert(a->trades[0].price == 99.0 && a->trades[0].quantity == 4);
+    // Only the owner hears about its fill
+    assert(a->fills.size() == 1 && b->fills.empty());
+    assert(a->fills[0].order_id == 500 && a->fills[0].side == Order::Side::BUY && a->fills[0].quantity == 4);
+    assert(a->tops.back().bid_quantity == 6);
+}
+
+// Callbacks that trade from inside a callback see later events in order, after the outer one
+struct ChasingStrategy : Strategy {
+    OrderBook& book;
+    std::vector<double> seen;
+    int next_id = 900;
+    explicit ChasingStrategy(OrderBook& ob) : book(ob) {}
+    void onTrade(const TradeEvent& trade) override {
+        seen.push_back(trade.price);
+        if (seen.size() == 1) {
+            book.addOrder(makeOrder(next_id++, Order::Side::BUY, 102.0, 1));
+            book.matchOrders();
+        }
+    }
+};
+
+void test_reentrant_callbacks() {
+    OrderBook ob;
+    StrategyEngine engine(ob, 0.5, 100);
+    ChasingStrategy* s = new ChasingStrategy(ob);
+    engine.addStrategy(std::unique_ptr<Strategy>(s));
+    ob.addOrder(Order(1, Order::Side::SELL, 101.0, 1, 1));
+    ob.addOrder(Order(2, Order::Side::SELL, 102.0, 1, 2));
+    ob.addOrder(Order(3, Order::Side::BUY, 101.0, 1, 3));
+    ob.matchOrders();
+    assert(s->seen.size() == 2);
+    assert(s->seen[0] == 101.0 && s->seen[1] == 102.0);
+    assert(ob.getSellOrders().empty());
+}
+
+void test_market_maker_quotes_on_events() {
+    OrderBook ob;
+    StrategyEngine engine(ob, 0.5, 100);
+    engine.addStrategy(std::unique_ptr<Strategy>(new MarketMakingStrategy(0.5, 10)));
+    // Quotes around the default mid as soon as it is added
+    assert(ob.getBuyOrders().size() == 1 && ob.getBuyOrders()[0].getPrice() == 99.75);
+    assert(ob.getSellOrders().size() == 1 && ob.getSellOrders()[0].getPrice() == 100.25);
+    assert(ob.getBuyOrders()[0].getOwnerID() == 1);
+    // Ticks without book changes do not requote
+    engine.run();
+    engine.run();
+    assert(ob.getBuyOrders().size() == 1 && ob.getSellOrders().size() == 1);
+}
+
+// Records arrival times of events and sends its orders through the engine
+struct TimedStrategy : Strategy {
+    LatencySimulator<OrderBook>* sim = nullptr;
+    std::vector<std::uint64_t> top_times;
+    std::vector<std::uint64_t> trade_times;
+    std::vector<OwnFill> fills;
+    void onTopOfBookChange(const TopOfBook&) override { top_times.push_back(sim->now()); }
+    void onTrade(const TradeEvent&) override { trade_times.push_back(sim->now()); }
+    void onOwnFill(const OwnFill& fill) override { fills.push_back(fill); }
+    void buy(int id, double price, int qty) { sendOrder(makeOrder(id, Order::Side::BUY, price, qty)); }
+    void cancel(int id) { sendCancel(id); }
+};
+
+void test_latency_routes_orders_and_events() {
+    OrderBook ob;
+    LatencyConfig config;
+    config.order_entry.base_ns = 5000;
+    config.market_data.base_ns = 3000;
+    config.tick_ns = 1000;
+    LatencySimulator<OrderBook> sim(ob, config);
+    StrategyEngine engine(ob, 0.5, 1);
+    engine.setLatencySimulator(&sim);
+    TimedStrategy* s = new TimedStrategy;
+    s->sim = &sim;
+    engine.addStrategy(std::unique_ptr<Strategy>(s));
+    engine.addStrategy(std::unique_ptr<Strategy>(new MarketMakingStrategy(0.5, 10)));
+    assert(s->top_times.size() == 1);
+
+    // The market maker quoted when it was added, but nothing reaches the book before the
+    // order-entry delay
+    sim.advanceTo(4000);
+    assert(ob.getBuyOrders().empty() && ob.getSellOrders().empty());
+    sim.advanceTo(5000);
+    assert(ob.getBuyOrders().size() == 1 && ob.getSellOrders().size() == 1);
+    // ...and the book change reaches strategies a market-data delay later
+    sim.advanceTo(7000);
+    assert(s->top_times.size() == 1);
+    sim.advanceTo(8000);
+    assert(s->top_times.size() == 3 && s->top_times[1] == 8000 && s->top_times[2] == 8000);
+
+    // Own order crosses the quoted ask: matched on arrival, fill seen 3us later
+    s->buy(1, 101.0, 4);
+    sim.advanceTo(12999);
+    assert(ob.getSellOrders()[0].getQuantity() == 10);
+    sim.advanceTo(13000);
+    assert(ob.getSellOrders()[0].getQuantity() == 6);
+    assert(s->trade_times.empty() && s->fills.empty());
+    sim.advanceTo(16000);
+    assert(s->trade_times.size() == 1 && s->trade_times[0] == 16000);
+    assert(s->fills.size() == 1 && s->fills[0].order_id == 1 && s->fills[0].quantity == 4);
+
+    // Cancels travel the same channel; an engine tick advances simulated time
+    s->buy(2, 99.0, 1);
+    s->cancel(2);
+    assert(ob.queuePosition(2) == -1);
+    engine.run();
+    assert(ob.queuePosition(2) == -1);
+    assert(sim.inFlight() == 0);
+    assert(sim.now() >= 16000 + 1000000);
+    // Still one quote per side: events in flight never made the maker double up
+    assert(ob.getBuyOrders().size() == 1 && ob.getSellOrders().size() == 1);
+}
+
+int main() {
+    test_top_of_book_changes();
+    test_trades_and_own_fills();
+    test_reentrant_callbacks();
+    test_market_maker_quotes_on_events();
+    test_latency_routes_orders_and_events();
+    std::cout << "Strategy engine tests passed!\n";
+    return 0;
+}
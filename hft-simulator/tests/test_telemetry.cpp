@@ -0,0 +1,182 @@
+#include "Telemetry.h"
+#include "OrderBook.h"
+#include <cassert>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+void test_counters_sum_across_threads() {
+    TelemetrySnapshot before = snapshotTelemetry();
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.push_back(std::thread([]() {
+            for (int i = 0; i < 100000; ++i) telemetryAdd(Metric::STRATEGY_STEPS);
+        }));
+    }
+    for (size_t t = 0; t < threads.size(); ++t) threads[t].join();
+    TelemetrySnapshot after = snapshotTelemetry();
+    // Slabs of finished threads still count
+    assert(after.get(Metric::STRATEGY_STEPS) - before.get(Metric::STRATEGY_STEPS) == 400000);
+}
+
+void test_order_book_reports_activity() {
+    TelemetrySnapshot before = snapshotTelemetry();
+    OrderBook ob;
+    ob.addOrder(Order(1, Order::Side::BUY, 101.0, 10, 1));
+    ob.addOrder(Order(2, Order::Side::BUY, 100.0, 10, 2));
+    ob.addOrder(Order(3, Order::Side::SELL, 101.0, 4, 3));
+    ob.addOrder(Order(4, Order::Side::SELL, 0.0, 5, 4, 200.0));
+    ob.matchOrders();
+    assert(ob.cancelOrder(2));
+    TelemetrySnapshot after = snapshotTelemetry();
+    assert(after.get(Metric::ORDERS_ADDED) - before.get(Metric::ORDERS_ADDED) == 4);
+    assert(after.get(Metric::FILLS) - before.get(Metric::FILLS) == 1);
+    assert(after.get(Metric::FILLED_QUANTITY) - before.get(Metric::FILLED_QUANTITY) == 4);
+    assert(after.get(Metric::ORDERS_CANCELLED) - before.get(Metric::ORDERS_CANCELLED) == 1);
+    assert(after.get(Metric::BUY_LEVELS) == 1);
+    assert(after.get(Metric::SELL_LEVELS) == 0);
+    assert(after.get(Metric::RESTING_ORDERS) == 1);
+    assert(after.get(Metric::PENDING_STOPS) == 1);
+}
+
+void test_format_includes_rates() {
+    TelemetrySnapshot previous;
+    TelemetrySnapshot current;
+    previous.taken_at_ns = 1000000000;
+    current.taken_at_ns = 3000000000;
+    current.values[static_cast<std::size_t>(Metric::FILLS)] = 50;
+    current.values[static_cast<std::size_t>(Metric::BUY_LEVELS)] = 7;
+    std::string text = formatTelemetry(current, &previous);
+    assert(text.find("fills_total 50\n") != std::string::npos);
+    assert(text.find("fills_per_sec 25\n") != std::string::npos);
+    assert(text.find("buy_levels 7\n") != std::string::npos);
+    assert(text.find("buy_levels_per_sec") == std::string::npos);
+}
+
+void test_file_dump() {
+    const std::string path = "test_telemetry.txt";
+    std::remove(path.c_str());
+    TelemetryExporter exporter;
+    assert(exporter.startFileDump(path, 10));
+    std::string contents;
+    for (int i = 0; i < 200 && contents.empty(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        std::ifstream in(path);
+        std::stringstream ss;
+        ss << in.rdbuf();
+        contents = ss.str();
+    }
+    exporter.stop();
+    assert(!exporter.isRunning());
+    assert(contents.find("orders_added_total") != std::string::npos);
+    std::remove(path.c_str());
+}
+
+#ifdef __linux__
+static std::string querySocket(const std::string& path, const std::string& request) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr = {};
+    addr.sun_family = AF_UNIX;
+    path.copy(addr.sun_path, path.size());
+    assert(connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0);
+    if (!request.empty()) send(fd, request.data(), request.size(), 0);
+    std::string response;
+    char buf[4096];
+    ssize_t n;
+    while ((n = recv(fd, buf, sizeof(buf), 0)) > 0) response.append(buf, static_cast<size_t>(n));
+    close(fd);
+    return response;
+}
+
+void test_socket_endpoint() {
+    const std::string path = "test_telemetry.sock";
+    TelemetryExporter exporter;
+    assert(exporter.startSocket(path));
+    telemetryAdd(Metric::TRADES_LOGGED, 3);
+    std::string plain = querySocket(path, "");
+    assert(plain.find("trades_logged_total") != std::string::npos);
+    std::string http = querySocket(path, "GET /metrics HTTP/1.0\r\n\r\n");
+    assert(http.compare(0, 15, "HTTP/1.0 200 OK") == 0);
+    assert(http.find("fills_total") != std::string::npos);
+    exporter.stop();
+}
+#endif
+
+void test_gauges_are_not_summed() {
+    // A structure updated from one thread and then another: the gauge is the latest
+    // reading, not the sum of what each thread last reported
+    telemetrySet(Metric::LOGGER_TRADES_HELD, 200);
+    std::thread engine([]() { telemetrySet(Metric::LOGGER_TRADES_HELD, 150); });
+    engine.join();
+    assert(snapshotTelemetry().get(Metric::LOGGER_TRADES_HELD) == 150);
+    telemetrySet(Metric::LOGGER_TRADES_HELD, 0);
+    assert(snapshotTelemetry().get(Metric::LOGGER_TRADES_HELD) == 0);
+
+    // A book loaded on one thread and then driven by another still counts once
+    OrderBook ob;
+    for (int i = 0; i < 200; ++i) ob.addOrder(Order(i, Order::Side::BUY, 90.0 + i % 4, 1, i));
+    std::thread driver([&ob]() {
+        for (int i = 0; i < 50; ++i) ob.cancelOrder(i);
+    });
+    driver.join();
+    assert(snapshotTelemetry().get(Metric::RESTING_ORDERS) == 150);
+}
+
+void test_book_gauges_total_every_book() {
+    // One book per symbol, as in an ITCH replay: each book's share survives the others' updates
+    {
+        OrderBook first;
+        std::unique_ptr<OrderBook> second(new OrderBook);
+        first.addOrder(Order(1, Order::Side::BUY, 100.0, 1, 1));
+        first.addOrder(Order(2, Order::Side::BUY, 99.0, 1, 2));
+        second->addOrder(Order(1, Order::Side::SELL, 101.0, 1, 1));
+        TelemetrySnapshot both = snapshotTelemetry();
+        assert(both.get(Metric::RESTING_ORDERS) == 3);
+        assert(both.get(Metric::BUY_LEVELS) == 2 && both.get(Metric::SELL_LEVELS) == 1);
+        first.cancelOrder(2);
+        assert(snapshotTelemetry().get(Metric::RESTING_ORDERS) == 2);
+        // A book that goes away takes its share with it
+        second.reset();
+        assert(snapshotTelemetry().get(Metric::RESTING_ORDERS) == 1);
+        assert(snapshotTelemetry().get(Metric::SELL_LEVELS) == 0);
+    }
+    assert(snapshotTelemetry().get(Metric::RESTING_ORDERS) == 0);
+    assert(snapshotTelemetry().get(Metric::BUY_LEVELS) == 0);
+}
+
+void test_update_cost() {
+    const int n = 10000000;
+    TelemetrySnapshot before = snapshotTelemetry();
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int i = 0; i < n; ++i) telemetryAdd(Metric::STRATEGY_STEPS);
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / n;
+    std::cout << "telemetryAdd: " << ns << " ns/update\n";
+    // Load-plus-store updates lose nothing from a single writer
+    assert(snapshotTelemetry().get(Metric::STRATEGY_STEPS) - before.get(Metric::STRATEGY_STEPS) == n);
+}
+
+int main() {
+    test_counters_sum_across_threads();
+    test_order_book_reports_activity();
+    test_format_includes_rates();
+    test_file_dump();
+#ifdef __linux__
+    test_socket_endpoint();
+#endif
+    test_gauges_are_not_summed();
+    test_book_gauges_total_every_book();
+    test_update_cost();
+    std::cout << "Telemetry tests passed!\n";
+    return 0;
+}
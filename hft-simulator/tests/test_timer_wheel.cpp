@@ -0,0 +1,144 @@
+#include "TimerWheel.h"
+#include "LatencySimulator.h"
+#include "BasicOrderBook.h"
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <random>
+#include <vector>
+
+void test_wheel_expires_in_deadline_order() {
+    TimerWheel<int> wheel;
+    std::mt19937_64 rng(7);
+    std::vector<std::uint64_t> deadlines;
+    // Spread deadlines across every level and into the overflow list
+    for (int i = 0; i < 5000; ++i) {
+        std::uint64_t when = rng() % (std::uint64_t(1) << (8 + (i % 33)));
+        deadlines.push_back(when);
+        wheel.schedule(when, i);
+    }
+    std::vector<std::uint64_t> expired;
+    std::uint64_t horizon = std::uint64_t(1) << 41;
+    wheel.advance(horizon, [&](std::uint64_t when, int id) {
+        assert(deadlines[id] == when);
+        expired.push_back(when);
+    });
+    assert(wheel.empty());
+    assert(expired.size() == deadlines.size());
+    assert(std::is_sorted(expired.begin(), expired.end()));
+}
+
+void test_wheel_partial_advance() {
+    TimerWheel<int> wheel(100);
+    wheel.schedule(150, 1);
+    wheel.schedule(400, 2);
+    wheel.schedule(70000, 3);
+    std::vector<int> seen;
+    auto record = [&](std::uint64_t, int id) { seen.push_back(id); };
+    wheel.advance(149, record);
+    assert(seen.empty());
+    wheel.advance(400, record);
+    assert((seen == std::vector<int>{1, 2}));
+    assert(wheel.size() == 1);
+    wheel.advance(69999, record);
+    assert(seen.size() == 2);
+    wheel.advance(70000, record);
+    assert(seen.size() == 3 && wheel.now() == 70000);
+}
+
+void test_wheel_ties_are_fifo() {
+    TimerWheel<int> wheel;
+    // Same deadline reached through different levels
+    wheel.schedule(1000, 1);
+    wheel.advance(600, [](std::uint64_t, int) {});
+    wheel.schedule(1000, 2);
+    wheel.advance(999, [](std::uint64_t, int) {});
+    wheel.schedule(1000, 3);
+    wheel.schedule(5, 4); // already due
+    std::vector<int> seen;
+    wheel.advance(1000, [&](std::uint64_t, int id) { seen.push_back(id); });
+    assert((seen == std::vector<int>{4, 1, 2, 3}));
+}
+
+void test_wheel_reschedule_from_callback() {
+    TimerWheel<int> wheel;
+    wheel.schedule(10, 0);
+    int fired = 0;
+    wheel.advance(10000, [&](std::uint64_t when, int id) {
+        ++fired;
+        if (id < 5) wheel.schedule(when + 300, id + 1);
+    });
+    assert(fired == 6);
+    assert(wheel.empty());
+}
+
+struct RecordingSink : NullEventSink {
+    std::vector<Fill> fills;
+    void onFill(const Fill& fill) { fills.push_back(fill); }
+};
+
+void test_latency_simulator_delays_orders() {
+    typedef BasicOrderBook<RecordingSink, SimulatedClock> Book;
+    Book book;
+    LatencyConfig config;
+    config.order_entry.base_ns = 5000;
+    config.market_data.base_ns = 2000;
+    config.tick_ns = 1000;
+    LatencySimulator<Book> sim(book, config);
+
+    assert(sim.submitOrder(1, Order(1, Order::Side::SELL, 100.0, 10, 0)) == 5000);
+    sim.advanceTo(1000);
+    assert(sim.submitOrder(2, Order(2, Order::Side::BUY, 100.0, 10, 1000)) == 6000);
+    assert(sim.inFlight() == 2);
+    sim.advanceTo(4999);
+    assert(book.getSellOrders().empty());
+    sim.advanceTo(5000);
+    assert(book.getSellOrders().size() == 1);
+    sim.advanceTo(7000);
+    assert(book.getSellOrders().empty());
+    assert(book.eventSink().fills.size() == 1);
+    assert(book.eventSink().fills[0].timestamp == 6000);
+
+    bool delivered = false;
+    sim.publishMarketData(1, [&]() { delivered = true; });
+    sim.advanceTo(8999);
+    assert(!delivered);
+    sim.advanceTo(9000);
+    assert(delivered);
+}
+
+void test_latency_simulator_keeps_channel_order() {
+    typedef BasicOrderBook<RecordingSink, SimulatedClock> Book;
+    Book book;
+    LatencyConfig config;
+    config.order_entry.kind = LatencyDistribution::Kind::EXPONENTIAL;
+    config.order_entry.base_ns = 1000;
+    config.order_entry.jitter_ns = 50000.0;
+    config.tick_ns = 100;
+    LatencySimulator<Book> sim(book, config);
+    std::uint64_t last = 0;
+    for (int i = 0; i < 1000; ++i) {
+        std::uint64_t arrival = sim.submitOrder(1, Order(i, Order::Side::BUY, 90.0, 1, i));
+        assert(arrival >= last);
+        last = arrival;
+    }
+    // Cancel of the last order arrives after it, even with jitter
+    sim.submitCancel(1, 999);
+    sim.advanceTo(last + 10000000);
+    std::vector<Order> buys = book.getBuyOrders();
+    assert(buys.size() == 999);
+    for (size_t i = 0; i < buys.size(); ++i) {
+        assert(buys[i].getOrderID() == static_cast<int>(i));
+    }
+}
+
+int main() {
+    test_wheel_expires_in_deadline_order();
+    test_wheel_partial_advance();
+    test_wheel_ties_are_fifo();
+    test_wheel_reschedule_from_callback();
+    test_latency_simulator_delays_orders();
+    test_latency_simulator_keeps_channel_order();
+    std::cout << "TimerWheel and latency simulator tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,142 @@
+#include "TradeAnalytics.h"
+#include "TradeLogger.h"
+#include "Utils.h"
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+
+FillRecord fill(std::uint64_t ts, double price, int qty, bool buy_aggressor, int buy_owner, int sell_owner) {
+    static int next_id = 1;
+    FillRecord record = {ts, price, qty, next_id, next_id + 1, buy_aggressor, buy_owner, sell_owner};
+    next_id += 2;
+    return record;
+}
+
+void test_metrics_on_small_log() {
+    TradeColumns trades;
+    trades.append(fill(0, 100.0, 10, true, 1, 2));
+    trades.append(fill(5, 101.0, 10, true, 1, 2));
+    trades.append(fill(12, 99.0, 5, false, 2, 1));
+    trades.append(fill(25, 102.0, 15, false, 2, 1));
+    AnalyticsOptions options;
+    options.interval = 10;
+    AnalyticsReport report = analyzeTrades(trades, options);
+
+    assert(report.fills == 4 && report.volume == 40);
+    assert(report.intervals.size() == 3);
+    assert(report.intervals[0].trades == 2 && report.intervals[0].volume == 20 && report.intervals[0].vwap == 100.5);
+    assert(report.intervals[1].start == 10 && report.intervals[1].vwap == 99.0);
+    // Equity 0 -> 10 -> -30 -> 15 fill by fill
+    assert(report.intervals[0].equity == 10.0 && report.intervals[0].inventory == 20);
+    assert(report.intervals[1].equity == -30.0 && report.intervals[1].inventory == 15);
+    assert(report.final_equity == 15.0 && report.final_inventory == 0);
+    assert(report.max_drawdown == 40.0);
+    // Interval changes 10, -40, 45
+    assert(std::fabs(report.sharpe - 5.0 / std::sqrt(1825.0)) < 1e-12);
+    assert(std::fabs(report.sortino - 5.0 / std::sqrt(1600.0 / 3.0)) < 1e-12);
+
+    assert(report.owners.size() == 2);
+    const OwnerStats& one = report.owners[0];
+    assert(one.owner_id == 1 && one.fills == 4 && one.bought == 20 && one.sold == 20);
+    // Bought 10 @ 100 and 10 @ 101 against a 100.5 VWAP: -5 + 5
+    assert(one.slippage == 0.0);
+    assert(report.owners[1].slippage == 0.0);
+
+    // Owner 1 was the aggressor of every fill, so its account matches
+    options.account = 1;
+    AnalyticsReport owner = analyzeTrades(trades, options);
+    assert(owner.final_equity == report.final_equity && owner.max_drawdown == report.max_drawdown);
+    options.account = 2;
+    // The other side: equity 0 -> -10 -> 30 -> -15
+    assert(analyzeTrades(trades, options).max_drawdown == 45.0);
+    options.account = 7;
+    assert(analyzeTrades(trades, options).final_equity == 0.0);
+}
+
+// Chunked passes must agree with a single thread (values chosen to sum exactly)
+void test_threads_agree() {
+    TradeColumns trades;
+    std::uint64_t seed = 42;
+    for (int i = 0; i < 1000000; ++i) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        double price = 100.0 + static_cast<double>((seed >> 33) % 64) * 0.25;
+        int qty = 1 + static_cast<int>((seed >> 20) % 50);
+        trades.append(fill(static_cast<std::uint64_t>(i) * 1000, price, qty, (seed >> 60) & 1, 1 + (seed >> 40) % 4, 1 + (seed >> 45) % 4));
+    }
+    AnalyticsOptions options;
+    options.interval = 100000;
+    options.threads = 1;
+    AnalyticsReport serial = analyzeTrades(trades, options);
+    options.threads = 8;
+    AnalyticsReport parallel = analyzeTrades(trades, options);
+    assert(serial.volume == parallel.volume && serial.notional == parallel.notional);
+    assert(serial.final_equity == parallel.final_equity && serial.max_drawdown == parallel.max_drawdown);
+    assert(serial.sharpe == parallel.sharpe && serial.sortino == parallel.sortino);
+    assert(serial.intervals.size() == 10000 && parallel.intervals.size() == 10000);
+    for (std::size_t i = 0; i < serial.intervals.size(); ++i) {
+        assert(serial.intervals[i].volume == parallel.intervals[i].volume);
+        assert(serial.intervals[i].equity == parallel.intervals[i].equity);
+        assert(serial.intervals[i].inventory == parallel.intervals[i].inventory);
+    }
+    assert(serial.owners.size() == 4 && parallel.owners.size() == 4);
+    for (std::size_t i = 0; i < serial.owners.size(); ++i) {
+        assert(serial.owners[i].bought == parallel.owners[i].bought);
+        assert(serial.owners[i].notional == parallel.owners[i].notional);
+        assert(serial.owners[i].slippage == parallel.owners[i].slippage);
+    }
+}
+
+void test_load_logger_outputs() {
+    std::string base = "/tmp/hft_analytics_test_" + std::to_string(getpid());
+    std::uint64_t raw[] = {1700000000123ULL, 1700000001456ULL, 1700000005789ULL};
+    {
+        TradeLogger csv(base + ".csv");
+        TradeLogger columnar(base + ".col", TradeOutputFormat::COLUMNAR);
+        for (int i = 0; i < 3; ++i) {
+            Trade trade = {i, 100 + i, 99.5 + i, 10 * (i + 1), formatTimestamp(raw[i]), i == 1 ? "BUY" : "SELL", raw[i], 3, 4};
+            csv.logTrade(trade);
+            columnar.logTrade(trade);
+        }
+    }
+    TradeColumns from_csv;
+    TradeColumns from_columnar;
+    assert(loadTrades(base + ".csv", from_csv));
+    assert(loadTrades(base + ".col", from_columnar, 2));
+    assert(from_csv.size() == 3 && from_columnar.size() == 3);
+    for (std::size_t i = 0; i < 3; ++i) {
+        assert(from_csv.price_ticks[i] == from_columnar.price_ticks[i] && from_csv.quantity[i] == from_columnar.quantity[i]);
+        assert(from_csv.buy_aggressor[i] == (i == 1 ? 1 : 0) && from_columnar.buy_aggressor[i] == from_csv.buy_aggressor[i]);
+        assert(from_csv.sell_order_id[i] == from_columnar.sell_order_id[i]);
+        assert(from_columnar.timestamp[i] == raw[i]);
+        assert(from_columnar.buy_owner_id[i] == 3 && from_csv.buy_owner_id[i] == 0);
+    }
+    // The CSV keeps whole seconds, shifted by at most a day of time zone
+    std::int64_t gap = static_cast<std::int64_t>(from_csv.timestamp[2] - from_csv.timestamp[0]);
+    assert(gap == 5000);
+    std::int64_t skew = static_cast<std::int64_t>(from_csv.timestamp[0]) - static_cast<std::int64_t>(raw[0] / 1000 * 1000);
+    assert(skew % 1000 == 0 && std::llabs(skew) <= 86400000);
+
+    std::vector<Order> orders;
+    orders.push_back(Order(0, Order::Side::BUY, 99.5, 20, 1));
+    orders.push_back(Order(100, Order::Side::SELL, 99.5, 10, 1));
+    orders.push_back(Order(55, Order::Side::SELL, 99.5, 10, 1));
+    FillRatio ratio = computeFillRatio(orders, from_columnar);
+    assert(ratio.orders == 3 && ratio.orders_filled == 2);
+    assert(ratio.submitted == 40 && ratio.filled == 20);
+    assert(ratio.ratio() == 0.5);
+
+    assert(!loadTrades(base + ".missing", from_csv));
+    std::remove((base + ".csv").c_str());
+    std::remove((base + ".col").c_str());
+}
+
+int main() {
+    test_metrics_on_small_log();
+    test_threads_agree();
+    test_load_logger_outputs();
+    std::cout << "Trade analytics tests passed!\n";
+    return 0;
+}